@@ -0,0 +1,78 @@
+/*
+bytecode.h
+
+Declares the compact bytecode that process programs are lowered into at creation time.
+Opcodes are fixed width, constants are parsed once, and variables are resolved to
+register slots so execution never touches strings.
+*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "string_pool.h"
+
+struct InstructionSet;
+
+enum class Opcode : uint8_t {
+    PRINT,      // a/b = low/high halves of the message StrId
+    DECLARE,    // registers[dst] = a
+    ADD,        // registers[dst] = clamp(A + B)
+    SUBTRACT,   // registers[dst] = max(A - B, 0)
+    SLEEP,      // a = ticks
+    LOOP_BEGIN, // a = repeats, target = index just past the matching LOOP_END
+    LOOP_END    // target = index of the first body op
+};
+
+// Operand kinds for ADD/SUBTRACT: when the bit is set the operand is a register slot,
+// otherwise it is an immediate constant.
+const uint8_t OPERAND_A_SLOT = 0x1;
+const uint8_t OPERAND_B_SLOT = 0x2;
+
+struct Op {
+    Opcode code;
+    uint8_t flags;
+    uint16_t dst;
+    uint16_t a;
+    uint16_t b;
+};
+
+static_assert(sizeof(Op) == 8, "Op must stay fixed width");
+
+inline StrId opString(const Op& op) {
+    return StrId(op.a) | (StrId(op.b) << 16);
+}
+
+// Loop jump targets are 32-bit op indices split across dst (low half) and b (high half),
+// so program length is not limited by the 16-bit operand fields.
+inline uint32_t opTarget(const Op& op) {
+    return uint32_t(op.dst) | (uint32_t(op.b) << 16);
+}
+
+inline void setOpTarget(Op& op, uint32_t target) {
+    op.dst = static_cast<uint16_t>(target & 0xFFFF);
+    op.b = static_cast<uint16_t>(target >> 16);
+}
+
+// Upper bound on distinct variables per process; the generator only uses x, y and z.
+const size_t MAX_REGISTERS = 8;
+
+// Deepest FOR nesting the loop-counter stack can hold (generateFor stops at depth 3).
+const size_t MAX_LOOP_DEPTH = 3;
+
+// FOR trees are flattened into one linear op stream; loop bodies are bracketed by
+// LOOP_BEGIN/LOOP_END, which are bookkeeping only and never count as instructions.
+// The op vector is the program's only heap allocation.
+struct Program {
+    std::vector<Op> code;
+    std::array<StrId, MAX_REGISTERS> slotNames{};
+    uint8_t slotCount = 0;
+};
+
+Program compileProgram(const InstructionSet& instructions);
+
+// Compiles more ops onto the end of an existing program, reusing its register slots.
+// Streamed programs use this to refill their op window.
+void appendProgram(Program& program, const InstructionSet& instructions);
@@ -0,0 +1,27 @@
+/*
+clock_service.h
+
+Declares the emulator-wide clock. A background thread formats the wall-clock
+timestamp once per second and publishes it lock-free, so readers on core, generator
+and UI threads never call localtime themselves. It also carries the CPU tick counter
+and a monotonic nanosecond stamp for instrumentation.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+void startClockService();
+void stopClockService();
+
+// Cached "%m/%d/%Y %I:%M:%S %p" string and the second it describes. Both fall back to
+// formatting on the spot when the service is not running.
+std::string cachedTimestamp();
+std::time_t cachedEpochSeconds();
+
+uint64_t currentTick();
+void advanceTick();
+
+uint64_t monotonicNanos();
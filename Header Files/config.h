@@ -8,6 +8,7 @@ Declares the Config struct and function prototypes for config file parsing and v
 
 #include <string>
 #include <cstdint>
+#include <vector>
 
 
 struct Config {
@@ -17,7 +18,17 @@ struct Config {
     uint32_t batchProcFreq;
     uint32_t minIns;
     uint32_t maxIns;
-    uint32_t delayPerExec;
+    uint32_t delayPerExec;      // CPU ticks of delay per executed instruction
+    uint32_t cpuTickUs = 1000;  // length of one CPU tick in microseconds
+    uint32_t logCapacity = 100; // PRINT log records kept per process
+    std::string logArchive;     // file finished processes spill logs to; empty = off
+    std::string programSource = "eager";    // "eager" or "stream"
+    uint64_t seed = 0;          // master workload seed; 0 = pick one at startup
+    uint32_t mlfqLevels = 3;
+    std::vector<uint32_t> mlfqQuanta;       // per level; empty = quantum-cycles << level
+    uint32_t mlfqBoostTicks = 1000;         // 0 = never boost
+    std::string cpuAffinity = "off";        // "off", "auto", or "map" for an explicit list
+    std::vector<int> cpuAffinityMap;        // host CPU per core, used when cpuAffinity is "map"
 };
 
 bool loadConfig(const std::string& filename, Config& config);
\ No newline at end of file
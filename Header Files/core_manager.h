@@ -2,46 +2,92 @@
 
 #include "process.h"
 #include "config.h"
+#include "scheduler_policy.h"
+#include "process_registry.h"
+#include "delay_engine.h"
+#include "log_archive.h"
+#include "process_pool.h"
+#include "timer_wheel.h"
+#include "core_stats.h"
+#include "latency_histogram.h"
 #include <string>
 #include <vector>
-#include <queue>
 #include <mutex>
-#include <condition_variable>
 #include <thread>
 #include <atomic>
-#include <random>
+#include <memory>
+#include <chrono>
+#include <ostream>
+
+// Finished processes shown by screen -ls and report-util when no count is given.
+const size_t DEFAULT_FINISHED_LIMIT = 20;
+
+// Totals of one runWorkload() call.
+struct WorkloadResult {
+    uint64_t processes = 0;
+    uint64_t instructions = 0;
+    uint64_t dispatches = 0;
+    uint64_t preemptions = 0;
+    uint64_t migrations = 0;
+    double seconds = 0;
+};
 
 class CoreManager {
 public:
     CoreManager();
     ~CoreManager();
 
-    void configure(uint32_t coresCount,
-                   const std::string& schedType,
-                   uint32_t quantum,
-                   uint32_t batchFreq,
-                   uint32_t minI,
-                   uint32_t maxI,
-                   uint32_t delay);
+    void configure(const Config& config);
 
     void start();
     void stopScheduler();
+    // Stops and joins the core and tick threads without stopScheduler()'s console output.
+    void haltCores();
 
     void startSchedulerThread(const Config& config);     // equivalent to scheduler-start
     void stopSchedulerThread();      // equivalent to scheduler-stop
 
     void addProcess(Process* proc);
-    void reportUtil();
+    void addProcesses(Process* const* procs, size_t count);
     void listProcessStatus();
-    void printProcessSummary(std::ostream& out, bool colorize);
-    Process* getProcessByName(const std::string& name);
+    void printProcessSummary(std::ostream& out, bool colorize, size_t finishedLimit = DEFAULT_FINISHED_LIMIT);
+    void printCoreUtilization(std::ostream& out);
+    void printProcessMetrics(std::ostream& out);
+    // Latency histograms of one core, or of all cores merged when coreId < 0.
+    void printLatency(std::ostream& out, int coreId = -1);
+    // Starts writing one row per finished process to <prefix>.csv as it finishes.
+    bool streamProcessMetrics(const std::string& prefix);
+    // Flushes the streamed rows and writes the aggregates to <prefix>.json.
+    bool exportProcessMetrics(const std::string& prefix);
+    bool hasProcess(const std::string& name) const;
+    // A live process for screen -r, pinned so it stays readable even if it finishes;
+    // nullptr when there is none. Every attached process is passed to detachProcess().
+    Process* attachProcess(const std::string& name);
+    void detachProcess(Process* proc);
+    // Creates and attaches a process for screen -s; nullptr (after reporting why) when
+    // the process could not be built.
     Process* spawnNewNamedProcess(const std::string& name);
-    int generateRandomInstructionCount() const;
+    uint64_t workloadSeed() const { return masterSeed; }
+
+    // Headless discrete-event run on virtual time (see simulation.cpp).
+    void runSimulation(uint64_t processCount, std::ostream& out);
+
+    // Headless run on the real core threads: creates processCount seeded processes,
+    // admits them all at once and returns when every one has finished. Only the time
+    // from admission to the last finish is measured.
+    WorkloadResult runWorkload(uint64_t processCount);
 
 private:
+    template <class Policy> friend class PolicyScheduler;
+
     void tickLoop();
+    void resetCoreState();
+    Process* createProcess(const std::string& name, int id) const;
+    void ensureProcessPool();
     void coreWorker(int coreId);
-    void busyWait(uint32_t milliseconds);
+    void wakeProcesses(const std::vector<Process*>& procs);
+    template <class Policy> void coreLoop(Policy& policy, int coreId);
+    template <class Policy> void simulate(Policy& policy, uint64_t processCount, std::ostream& out);
 
     uint32_t numCores = 1;
     std::string schedulerType = "fcfs";
@@ -50,23 +96,39 @@ private:
     uint32_t minIns = 1;
     uint32_t maxIns = 5;
     uint32_t delayPerExec = 0;
-    uint32_t processCounter = 0;
+    uint32_t logCapacity = 100;
+    ProgramSource programSource = ProgramSource::EAGER;
+    std::chrono::microseconds tickDuration{1000};
+    uint64_t masterSeed = 0;
+    std::vector<int> corePinning;           // host CPU per core; empty when not pinned
+    ProcessPool processPool;
 
     std::vector<std::thread> cores;
     std::thread tickThread;
     std::thread schedulerThread;
 
-    std::vector<bool> coreBusy;
-    std::vector<uint32_t> coreInstructions;
+    Config settings;                        // as last passed to configure()
+    std::unique_ptr<Scheduler> scheduler;
+    ProcessRegistry registry;
 
-    std::queue<Process*> readyQueue;
-    std::vector<Process*> allProcesses;
-    std::mutex queueMutex;
-    std::condition_variable queueCond;
+    // Scheduler state kept up to date at every transition so reports never scan
+    // the registry: what each core is running, the queue length, and summaries of
+    // the latest completions. A core takes runningLocks[core] before deleting a
+    // process it ran, so a report holding it can read runningOn[core] safely.
+    std::unique_ptr<std::atomic<Process*>[]> runningOn;
+    std::unique_ptr<std::mutex[]> runningLocks;
+    std::atomic<uint32_t> busyCores{0};
+    std::atomic<uint64_t> queuedCount{0};
+    FinishedHistory finished;
+    TimerWheel sleepers;                    // processes off-core in a SLEEP
+    CoreStats coreStats;
+    LatencyStats latencyStats;
+    MetricsLog metrics;                     // aggregates over finished processes
 
     std::atomic<bool> stop{false};
     std::atomic<bool> generating{false};
-    std::atomic<uint64_t> cpuTicks{0};
 
-    std::default_random_engine rng{std::random_device{}()};
+    DelayEngine delayEngine;
+    LogArchive logArchive;
+
 };
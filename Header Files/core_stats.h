@@ -0,0 +1,75 @@
+/*
+core_stats.h
+
+Declares the per-core utilisation counters. Each core has its own cache line of
+counters with a single writer, its core thread, which counts instructions, dispatches,
+preemptions and the wall-clock time it spent running processes. Once a second the
+tick thread copies every counter into a bounded history, from which reports derive
+sliding-window utilisation (busy time over elapsed time) and a per-second series.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Seconds of per-second samples kept for report-util.
+const size_t CORE_HISTORY_SECONDS = 60;
+
+struct alignas(64) CoreCounters {
+    std::atomic<uint64_t> busyNanos{0};     // time spent running slices, in monotonicNanos()
+    std::atomic<uint64_t> instructions{0};
+    std::atomic<uint64_t> dispatches{0};
+    std::atomic<uint64_t> preemptions{0};
+    std::atomic<uint64_t> migrations{0};    // dispatches of a process last run on another core
+};
+
+// Plain copy of one core's counters, with the time elapsed since reset() when taken.
+struct CoreSample {
+    uint64_t busyNanos = 0;
+    uint64_t elapsedNanos = 0;
+    uint64_t instructions = 0;
+    uint64_t dispatches = 0;
+    uint64_t preemptions = 0;
+    uint64_t migrations = 0;
+};
+
+// Fraction of the sample's elapsed time the core spent running processes.
+double busyShare(const CoreSample& sample);
+
+// Counters have exactly one writer each, so an increment is a relaxed load and store.
+inline void bumpCounter(std::atomic<uint64_t>& counter, uint64_t by = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+class CoreStats {
+public:
+    // Zeroes the counters and history for a machine with the given number of cores.
+    void reset(uint32_t cores);
+
+    uint32_t size() const { return coreCount; }
+    CoreCounters& core(uint32_t id) { return counters[id]; }
+    CoreSample total(uint32_t id) const;
+
+    // Tick thread, once per second: appends the current counters to the history.
+    void recordSecond();
+
+    // Change over the last `seconds` recorded seconds, or over as many as are held.
+    // Returns the number of seconds the window actually covers.
+    size_t window(uint32_t id, size_t seconds, CoreSample& out) const;
+
+    // Busy share of each recorded second, oldest first.
+    std::vector<double> series(uint32_t id) const;
+
+private:
+    std::unique_ptr<CoreCounters[]> counters;
+    uint32_t coreCount = 0;
+    uint64_t resetAtNanos = 0;
+
+    mutable std::mutex historyMutex;
+    std::deque<std::vector<CoreSample>> history;     // CORE_HISTORY_SECONDS + 1 snapshots
+};
@@ -0,0 +1,25 @@
+/*
+cpu_affinity.h
+
+Declares host CPU pinning for the emulator's core threads. The cpu-affinity config key
+is "off" (the default), "auto", or an explicit list of host CPUs that simulated cores
+take in order. "auto" lists the host CPUs this process may run on NUMA node by node
+(on Linux), so a machine with fewer cores than the host stays on as few nodes as
+possible. Pinning is supported on Linux and Windows; elsewhere it is a no-op.
+*/
+
+#pragma once
+
+#include "config.h"
+
+#include <vector>
+
+// Host CPUs available to this process, grouped by NUMA node where the host reports it.
+std::vector<int> hostCpuOrder();
+
+// Host CPU for each simulated core, or an empty plan when pinning is off. Invalid
+// entries are reported and disable pinning.
+std::vector<int> planCoreAffinity(const Config& config, uint32_t cores);
+
+// Pins the calling thread to one host CPU. False when unsupported or refused.
+bool pinCurrentThread(int hostCpu);
@@ -0,0 +1,26 @@
+/*
+delay_engine.h
+
+Declares the hybrid sleep/spin timer used for delay-per-exec. It sleeps for most of a
+delay and only spins (yielding) for the last stretch, whose length is calibrated from
+the host's measured sleep overshoot.
+*/
+
+#pragma once
+
+#include <chrono>
+
+class DelayEngine {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void calibrate();
+    bool isCalibrated() const { return calibrated; }
+
+    void waitFor(std::chrono::nanoseconds duration);
+    void waitUntil(Clock::time_point deadline);
+
+private:
+    bool calibrated = false;
+    std::chrono::nanoseconds spinWindow{std::chrono::milliseconds(2)};
+};
@@ -1,3 +1,4 @@
 #pragma once
 #include "process.h"
-Instruction generateAdd(const std::string& dest, const std::string& src1, const std::string& src2);
\ No newline at end of file
+#include "rng.h"
+Instruction generateAdd(Rng& rng, StrId dest);
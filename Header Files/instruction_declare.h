@@ -1,3 +1,3 @@
 #pragma once
 #include "process.h"
-Instruction generateDeclare(const std::string& varName, int value);
\ No newline at end of file
+Instruction generateDeclare(StrId var, int value);
@@ -1,3 +1,9 @@
 #pragma once
 #include "process.h"
-Instruction generateFor(const std::string& processName);
+#include "rng.h"
+
+// Appends the loop body to set.nodes and returns the FOR node that refers to it.
+Instruction generateFor(Rng& rng, InstructionSet& set);
+
+// Number of counted instructions ins executes once FOR bodies are unrolled.
+int dynamicInstructionCount(const InstructionSet& set, const Instruction& ins);
@@ -1,4 +1,6 @@
 #pragma once
 #include "process.h"
 
-Instruction generatePrint(const std::string& processName);
+// The message is a shared template; "{name}" is replaced with the process name
+// when the log is read.
+Instruction generatePrint();
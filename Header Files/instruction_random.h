@@ -1,5 +1,9 @@
 #pragma once
 #include "process.h"
-#include <vector>
 
-std::vector<Instruction> generateInstructionSet(const std::string& processName, int totalInstructions);
+// Appends the next top-level unit (a single instruction or a whole FOR) to out.
+// Returns false once the budget is spent.
+bool generateNextUnit(GeneratorState& state, InstructionSet& out);
+
+// Fills out (after clearing it) with a program of totalInstructions counted instructions.
+void generateInstructionSet(InstructionSet& out, int totalInstructions, uint64_t seed);
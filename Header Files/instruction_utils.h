@@ -1,12 +1,18 @@
 #pragma once
 #include <string>
-#include <cstdlib>
+#include "rng.h"
+#include "string_pool.h"
 
-inline std::string randomVarOrValue() {
-    const char* vars[] = {"x", "y", "z"};
-    if (rand() % 2 == 0) {
-        return vars[rand() % 3];
+// Interned ids of the generator's variable names x, y and z.
+inline StrId variableId(int index) {
+    static const StrId ids[] = {internString("x"), internString("y"), internString("z")};
+    return ids[index];
+}
+
+inline StrId randomVarOrValue(Rng& rng) {
+    if (rng.below(2) == 0) {
+        return variableId(rng.below(3));
     } else {
-        return std::to_string(rand() % 21);  // 0–20
+        return numberString(rng.below(21));  // 0–20
     }
 }
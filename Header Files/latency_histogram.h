@@ -0,0 +1,93 @@
+/*
+latency_histogram.h
+
+Declares the scheduler latency histograms. Each core owns one log-linear histogram
+per measured interval (enqueue to dispatch, ready-queue lock wait, wake-up after a
+notify, slice length), written only by that core's thread, so recording is a bucket
+lookup and a relaxed store. Reports merge the cores on demand.
+
+Queue and parking code does not know which core it runs on; CoreManager registers
+each core thread's histograms in a thread-local, and the record functions below are
+no-ops on any other thread.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+// Each power of two is split into 2^LATENCY_SUB_BITS linear buckets, so every bucket
+// is within 1/8 of its value; values below 2^LATENCY_SUB_BITS get a bucket each.
+const uint32_t LATENCY_SUB_BITS = 3;
+const uint32_t LATENCY_MAX_BITS = 40;       // about 18 minutes in nanoseconds
+const uint32_t LATENCY_BUCKETS = (LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS;
+
+enum class LatencyKind {
+    DISPATCH,       // ready (arrival, requeue or wake) until a core picks it up
+    LOCK_WAIT,      // acquiring a ready-queue lock from a core
+    WAKEUP,         // notify of a parked core until it runs again
+    SLICE,          // one dispatch on a core
+    COUNT
+};
+
+const char* latencyKindName(LatencyKind kind);
+
+class LatencyHistogram {
+public:
+    void record(uint64_t nanos);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return largest.load(std::memory_order_relaxed); }
+    double mean() const;
+    // Upper bound of the bucket holding the p-th fraction of samples.
+    uint64_t percentile(double p) const;
+
+private:
+    static uint32_t bucketOf(uint64_t nanos);
+    static uint64_t bucketUpper(uint32_t bucket);
+
+    std::atomic<uint64_t> buckets[LATENCY_BUCKETS] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> largest{0};
+};
+
+struct alignas(64) CoreLatency {
+    LatencyHistogram kinds[size_t(LatencyKind::COUNT)];
+    std::atomic<uint64_t> parks{0};
+    std::atomic<uint64_t> parkTimeouts{0};      // woke without a notify
+    std::atomic<uint64_t> emptyWakeups{0};      // notified, but the queue was empty again
+
+    LatencyHistogram& operator[](LatencyKind kind) { return kinds[size_t(kind)]; }
+    const LatencyHistogram& operator[](LatencyKind kind) const { return kinds[size_t(kind)]; }
+};
+
+class LatencyStats {
+public:
+    void reset(uint32_t cores);
+    uint32_t size() const { return coreCount; }
+    CoreLatency& core(uint32_t id) { return latency[id]; }
+
+    // Prints the histograms of one core, or of all cores merged when coreId < 0.
+    void print(std::ostream& out, int coreId = -1) const;
+
+private:
+    std::unique_ptr<CoreLatency[]> latency;
+    uint32_t coreCount = 0;
+};
+
+// Registers the calling core thread's histograms; nullptr when it stops.
+void setThreadLatency(CoreLatency* latency);
+CoreLatency* threadLatency();
+
+void recordLockWait(uint64_t nanos);
+// A parked core woke, either notified (wakeNanos after the notify) or by timeout.
+void recordPark(bool notified, uint64_t wakeNanos);
+void recordEmptyWakeup();
+
+// Locks mutex, timing the wait when the lock is contended and the caller is a core.
+std::unique_lock<std::mutex> timedLock(std::mutex& mutex);
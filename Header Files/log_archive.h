@@ -0,0 +1,28 @@
+/*
+log_archive.h
+
+Declares the append-only archive that finished processes spill their PRINT logs to
+before they are deleted, so logs survive without staying in memory.
+*/
+
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <string>
+
+class Process;
+
+class LogArchive {
+public:
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+
+    // Writes a summary line followed by every log line the process still holds.
+    void append(const Process& proc);
+
+private:
+    std::mutex mutex;
+    std::ofstream file;
+};
@@ -10,7 +10,13 @@ process state, instruction execution, and process screen interaction.
 #include <atomic>
 #include <ctime>
 #include <vector>
-#include <unordered_map>
+#include <array>
+#include <cstdint>
+#include "bytecode.h"
+#include "process_log.h"
+#include "process_metrics.h"
+#include "string_pool.h"
+#include "rng.h"
 
 enum class InstructionType {
     PRINT,
@@ -21,12 +27,73 @@ enum class InstructionType {
     FOR
 };
 
+// Generator output before it is compiled. Operands are interned strings, and a FOR
+// refers to its body as a range of nodes in the owning InstructionSet, so a whole
+// program lives in two flat vectors instead of one allocation per instruction.
 struct Instruction {
     InstructionType type;
-    std::vector<std::string> args;
-    std::vector<Instruction> block;
+    uint8_t argc;
+    StrId args[3];
+    uint32_t blockBegin;
+    uint32_t blockLen;
 };
 
+struct InstructionSet {
+    std::vector<Instruction> top;
+    std::vector<Instruction> nodes;     // FOR bodies, referenced by blockBegin/blockLen
+
+    void clear() {
+        top.clear();
+        nodes.clear();
+    }
+};
+
+// Everything needed to continue generating a program: its random stream and how many
+// counted instructions are still unassigned.
+struct GeneratorState {
+    Rng rng;
+    int remaining;
+    int declared = 0;   // leading x/y/z declarations emitted so far
+
+    GeneratorState(uint64_t seed = 0, int totalInstructions = 0) : rng(seed), remaining(totalInstructions) {}
+};
+
+enum class ProgramSource : uint8_t {
+    EAGER,      // whole program compiled when the process is created
+    STREAM      // ops generated a window at a time as the process runs
+};
+
+// Top-level units generated per refill of a streamed program's op window.
+const size_t STREAM_WINDOW_UNITS = 64;
+
+
+enum class ProcessState : uint8_t {
+    QUEUED,
+    RUNNING,
+    SLEEPING,
+    FINISHED
+};
+
+// A PRINT log record with its message resolved, as shown by process-smi.
+struct LogLine {
+    std::time_t time;
+    int32_t core;
+    std::string message;
+};
+
+// Why Process::runSlice returned control to the core.
+enum class SliceStop {
+    FINISHED,
+    SLEEP,
+    QUANTUM_EXPIRED,
+    STOPPED             // the scheduler is stopping; set by the core loop, not runSlice
+};
+
+struct SliceResult {
+    uint32_t steps;     // instructions plus sleep ticks consumed
+    uint32_t executed;  // counted instructions only
+    SliceStop reason;
+};
 
 class Process {
 public:
@@ -35,24 +102,51 @@ public:
     int totalInstructions;
     std::atomic<int> executedInstructions;
     int assignedCore;
+    std::atomic<ProcessState> state{ProcessState::QUEUED};
     std::string timestamp;
-    std::vector<std::string> logs;
+    std::time_t finishedAt = 0;
+    LogRing logs;
     int tickWaitCounter = 0;
 
-    Process(const std::string& name, int id, int totalIns);
+    // MLFQ bookkeeping, owned by whichever core or queue currently holds the process.
+    uint8_t queueLevel = 0;
+    uint32_t boostEpoch = 0;
+
+    // Scheduling timeline, kept by CoreManager in nanoseconds or by the simulator in ticks.
+    ProcessTimes times;
+
+    Process(const std::string& name, int id, int totalIns, uint64_t seed,
+            size_t logCapacity = DEFAULT_LOG_CAPACITY, ProgramSource source = ProgramSource::EAGER);
     bool isFinished() const;
-    void logPrint(const std::string& message);
+    void logPrint(StrId message);
+    std::vector<LogLine> readLogs() const;
+
+    // Called once the process finishes: frees its program. The logs stay until the
+    // process is deleted, right away unless a screen has it pinned, so an attached
+    // screen can still read them.
+    void compact();
 
-    std::vector<Instruction> instructions;
+    // For STREAM processes, program holds only the current window of ops and
+    // generator produces the rest on demand.
+    ProgramSource source;
+    GeneratorState generator;
+    Program program;
     size_t instructionPointer = 0;
-    std::unordered_map<std::string, uint16_t> variables;
+    std::array<uint16_t, MAX_REGISTERS> registers{};
 
     bool executeNextInstruction();
+    SliceResult runSlice(uint32_t maxSteps);
 
     int sleepTicks = 0;
-    std::vector<std::tuple<size_t, size_t, int>> forStack; 
+    std::array<uint16_t, MAX_LOOP_DEPTH> loopCounters{};
+    size_t loopDepth = 0;
 
-    void executeSingleInstruction(const Instruction& ins);
+    void executeSingleInstruction(const Op& op);
+    bool stepInstruction();
+    bool refillProgram();
+    uint16_t readOperand(uint16_t value, bool isSlot) const {
+        return isSlot ? registers[value] : value;
+    }
 };
 
 void enterProcessScreen(Process* proc);
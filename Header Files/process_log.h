@@ -0,0 +1,46 @@
+/*
+process_log.h
+
+Declares the per-process PRINT log: fixed-size binary records kept in a bounded ring
+buffer. Records hold only the time, core and message handle; they are turned into
+text only when process-smi or a report reads them.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <vector>
+
+const size_t DEFAULT_LOG_CAPACITY = 100;
+
+struct LogRecord {
+    std::time_t time;
+    int32_t core;
+    uint32_t message;   // interned message StrId
+};
+
+class LogRing {
+public:
+    explicit LogRing(size_t capacity = DEFAULT_LOG_CAPACITY) : capacity(capacity) {}
+
+    void append(const LogRecord& record);
+
+    // Calls f on each record currently held, oldest first, with the ring locked.
+    template <class F>
+    void forEach(F f) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = head; i < records.size(); ++i) f(records[i]);
+        for (size_t i = 0; i < head; ++i) f(records[i]);
+    }
+
+    uint64_t dropped() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<LogRecord> records;     // grows lazily up to capacity
+    size_t head = 0;                    // oldest record once the ring is full
+    uint64_t total = 0;
+    size_t capacity;
+};
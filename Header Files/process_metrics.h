@@ -0,0 +1,129 @@
+/*
+process_metrics.h
+
+Declares per-process scheduling metrics. Every process carries a ProcessTimes record
+that the scheduler updates at each transition (arrival, dispatch, leaving the core,
+becoming ready again, finishing). Live runs record monotonicNanos(), since most
+slices last far less than a CPU tick; --simulate records its virtual clock in ticks.
+The MetricsLog is told which unit it holds and converts only for display. When a process finishes
+its times are folded into a MetricsLog, which keeps running sums and a histogram per
+metric rather than a row per process, so its size does not grow with the number of
+finished processes. Rows go straight to a CSV file when one is being streamed.
+*/
+
+#pragma once
+
+#include "latency_histogram.h"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+struct Config;
+class Process;
+
+const uint64_t NOT_DISPATCHED = std::numeric_limits<uint64_t>::max();
+
+enum class MetricUnit {
+    TICKS,      // --simulate's virtual clock
+    NANOS       // monotonicNanos(), live runs
+};
+
+// Written only by whichever core or queue currently holds the process. All times are
+// in the unit of the clock the caller passes.
+struct ProcessTimes {
+    uint64_t arrivedAt = 0;
+    uint64_t firstDispatchAt = NOT_DISPATCHED;
+    uint64_t finishedAt = 0;
+    uint64_t readySince = 0;        // when it last entered the ready queue
+    uint64_t dispatchedAt = 0;      // when its current run on a core started
+    uint64_t waitTime = 0;          // total time ready but not running
+    uint64_t runTime = 0;           // total time on a core
+    uint32_t dispatches = 0;
+    uint32_t preemptions = 0;
+
+    void arrive(uint64_t now) { arrivedAt = readySince = now; }
+    void ready(uint64_t now) { readySince = now; }
+    void dispatch(uint64_t now) {
+        if (firstDispatchAt == NOT_DISPATCHED) firstDispatchAt = now;
+        waitTime += now - readySince;
+        dispatchedAt = now;
+        ++dispatches;
+    }
+    void release(uint64_t now) { runTime += now - dispatchedAt; }
+    void preempt(uint64_t now) {
+        ++preemptions;
+        readySince = now;
+    }
+    void finish(uint64_t now) { finishedAt = now; }
+};
+
+// What a finished process leaves behind; arrival is relative to the log's origin.
+struct ProcessMetrics {
+    uint64_t arrival = 0;
+    uint64_t response = 0;      // first dispatch - arrival
+    uint64_t turnaround = 0;    // finish - arrival
+    uint64_t wait = 0;
+    uint64_t run = 0;
+    uint32_t preemptions = 0;
+};
+
+enum class Metric {
+    RESPONSE,
+    TURNAROUND,
+    WAIT,
+    RUN,
+    PREEMPTIONS,
+    COUNT
+};
+
+// Means are exact; percentiles are the upper bound of a log-linear histogram bucket,
+// within 1/8 of the true value.
+struct MetricSummary {
+    double mean = 0;
+    uint64_t p50 = 0;
+    uint64_t p95 = 0;
+    uint64_t p99 = 0;
+};
+
+class MetricsLog {
+public:
+    MetricsLog();
+
+    // Forgets every finished process; a streamed CSV starts over with its header. Times
+    // recorded from now on are in `unit`, and arrivals are reported relative to origin.
+    void clear(MetricUnit unit, uint64_t origin = 0);
+    MetricUnit unit() const;
+    void record(const Process& proc);
+    uint64_t size() const;
+
+    // From now on each finished process also appends its row to path, which is
+    // truncated first. Rows are written as processes finish, never held in memory.
+    bool streamCsv(const std::string& path);
+    // Pushes buffered rows to disk. False when no CSV is streamed or writing failed.
+    bool flushCsv();
+
+    // In the log's unit; preemptions are a count.
+    MetricSummary summary(Metric metric) const;
+
+    // Writes a table of the summaries, with live times in microseconds.
+    void print(std::ostream& out) const;
+
+    // The run's settings and the summaries.
+    bool writeJson(const std::string& path, const Config& config, uint64_t seed) const;
+
+private:
+    bool openCsv();
+
+    mutable std::mutex mutex;
+    std::unique_ptr<LatencyHistogram[]> histograms;     // one per metric
+    uint64_t count = 0;
+    MetricUnit timeUnit = MetricUnit::TICKS;
+    uint64_t arrivalOrigin = 0;
+    std::string csvPath;
+    std::ofstream csv;
+};
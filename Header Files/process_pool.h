@@ -0,0 +1,64 @@
+/*
+process_pool.h
+
+Declares ProcessPool, which builds processes ahead of demand on a few worker threads.
+Processes are handed out strictly in id order, so a seeded workload is the same no
+matter which worker built which process.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Process;
+
+// Ready processes kept built ahead of the batch generator and screen -s.
+const size_t PROCESS_POOL_CAPACITY = 64;
+
+class ProcessPool {
+public:
+    typedef std::function<Process*(int id)> Factory;
+
+    ~ProcessPool();
+
+    // Starts workers calling factory for ids firstId, firstId + 1, ...
+    void start(Factory factory, int firstId, uint32_t workers);
+
+    // Joins the workers and frees processes that were built but never taken.
+    void stop();
+
+    // False once stopped or after a failed build; start() again to recover.
+    bool running() const;
+
+    // Next process in id order, waiting for a worker if it is not built yet. Throws
+    // std::runtime_error if the pool stops or building a process failed.
+    Process* take();
+
+    // Takes up to max processes in id order with one lock acquisition. Waits for the
+    // first one, then returns only those already built; the result is at least 1.
+    size_t takeBatch(Process** out, size_t max);
+
+    // Id the next take() will return.
+    int nextId() const;
+
+private:
+    void workerLoop();
+
+    Factory factory;
+    std::vector<std::thread> workers;
+    std::vector<Process*> slots;        // slots[id % capacity] once built
+
+    mutable std::mutex mutex;
+    std::condition_variable built;      // signalled when a slot is filled
+    std::condition_variable taken;      // signalled when a slot is freed
+    int64_t claimed = 0;                // next id a worker will build
+    int64_t next = 0;                   // next id a consumer will take
+    bool stopping = false;
+    std::string failure;                // set when the factory threw; stops the pool
+};
@@ -0,0 +1,118 @@
+/*
+process_registry.h
+
+Declares the registry of live processes and the bounded history of finished ones. Name
+and id lookups go through sharded hash indexes. A process leaves the registry when it
+finishes: a small summary goes into FinishedHistory, which keeps only the most recent
+ones, and the Process itself is deleted once no screen is attached to it. Memory
+therefore depends on how many processes are alive, not on how long the emulator runs.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Process;
+
+// Finished processes whose summaries are kept for screen -ls and report-util.
+const size_t FINISHED_HISTORY_CAPACITY = 4096;
+
+// What is kept of a process after it finishes.
+struct ProcessSummary {
+    std::string name;
+    int id = 0;
+    int core = -1;
+    std::string timestamp;          // when the process was created
+    std::time_t finishedAt = 0;
+    int totalInstructions = 0;
+};
+
+// Ring of the most recent FINISHED_HISTORY_CAPACITY summaries, in completion order.
+// Older summaries are overwritten; total() still counts every finished process.
+class FinishedHistory {
+public:
+    FinishedHistory();
+
+    void append(const Process& proc);
+    uint64_t total() const { return count.load(std::memory_order_acquire); }
+
+    // Copies of the last n summaries (fewer if fewer are held), oldest first.
+    std::vector<ProcessSummary> latest(size_t n) const;
+    void clear();
+
+private:
+    mutable std::mutex mutex;
+    std::vector<ProcessSummary> ring;
+    std::atomic<uint64_t> count{0};
+};
+
+class ProcessRegistry {
+public:
+    // Names are first come, first served: a later live process with the same name is
+    // still indexed by id, but name lookups keep returning the first one.
+    void add(Process* proc);
+    void addBatch(Process* const* procs, size_t count);
+
+    // Live processes only; a finished process is gone once retired.
+    bool containsName(const std::string& name) const;
+    Process* findById(int id) const;
+    size_t size() const { return live.load(std::memory_order_acquire); }
+
+    // A pinned process is not deleted while it is pinned, even after it finishes, so
+    // a screen can keep reading it. pinByName() returns nullptr for unknown names.
+    Process* pinByName(const std::string& name);
+    void pin(Process* proc);
+    // True when the process was retired while pinned and the caller must delete it.
+    bool unpin(Process* proc);
+
+    // Removes a finished process from the indexes. True when nothing pins it and the
+    // caller must delete it; otherwise the last unpin() reports that instead.
+    bool retire(Process* proc);
+
+    // Calls f(proc) for every live process, holding its index shard's lock.
+    template <class F>
+    void forEach(F&& f) const {
+        for (const auto& shard : idShards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& entry : shard.index) f(entry.second);
+        }
+    }
+
+    // Deletes every live process; only safe once no other thread uses them.
+    void deleteAll();
+
+private:
+    static const size_t SHARD_COUNT = 16;
+
+    struct Pin {
+        int count = 0;
+        bool retired = false;
+    };
+
+    // Pins live in the shard of the process's name, so a pin and a lookup by that
+    // name share one lock.
+    struct NameShard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Process*> index;
+        std::unordered_map<const Process*, Pin> pins;
+    };
+
+    struct IdShard {
+        mutable std::mutex mutex;
+        std::unordered_map<int, Process*> index;
+    };
+
+    NameShard& nameShard(const std::string& name) const;
+    IdShard& idShard(int id) const;
+
+    mutable NameShard nameShards[SHARD_COUNT];
+    mutable IdShard idShards[SHARD_COUNT];
+    std::atomic<size_t> live{0};
+};
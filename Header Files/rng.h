@@ -0,0 +1,65 @@
+/*
+rng.h
+
+Declares Rng, the small pseudo-random generator used to build process programs.
+It is xoshiro128** seeded through splitmix64: 16 bytes of state, so a process can
+carry its own generator and produce its program piece by piece. Every process seed is
+derived from the master `seed` config key and the process id, so a config and seed
+always produce the same programs, whichever thread creates them.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// Independent seed for stream number `stream` under a master seed (splitmix64 finaliser),
+// so each process gets its own generator without any shared state.
+inline uint64_t deriveSeed(uint64_t master, uint64_t stream) {
+    uint64_t z = master + (stream + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0) {
+        for (auto& word : s) {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            word = static_cast<uint32_t>(z ^ (z >> 31));
+        }
+    }
+
+    uint32_t next() {
+        uint32_t result = rotl(s[1] * 5, 7) * 9;
+        uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    // Uniform value in [0, n).
+    int below(int n) {
+        return static_cast<int>((uint64_t(next()) * uint32_t(n)) >> 32);
+    }
+
+    // Uniform value in [lo, hi].
+    uint32_t between(uint32_t lo, uint32_t hi) {
+        if (hi <= lo) return lo;
+        return lo + static_cast<uint32_t>((uint64_t(next()) * (uint64_t(hi - lo) + 1)) >> 32);
+    }
+
+private:
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    uint32_t s[4];
+};
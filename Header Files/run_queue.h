@@ -0,0 +1,177 @@
+/*
+run_queue.h
+
+Declares the per-core ready queues used by CoreManager: a lock-free work-stealing deque
+per core, a global injection queue for newly created processes, a small inbox per core
+for processes handed back to the idle core they last ran on, and an idle-core bitmap
+with per-core parking so enqueues wake exactly one sleeping core. The
+size-aware policies and FCFS use PriorityRunQueue instead, a shared heap keyed on
+remaining instructions or on arrival time.
+*/
+
+#pragma once
+
+#include "latency_histogram.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Process;
+
+// Bounded Chase-Lev deque. Only the owning core pushes; any core (including the owner)
+// takes from the top, so each core's local queue is FIFO and RR order is preserved.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 1024);
+
+    bool push(Process* proc);   // owner only; false when full
+    Process* steal();           // any thread; nullptr when empty
+    bool empty() const;
+
+private:
+    std::unique_ptr<std::atomic<Process*>[]> buffer;
+    int64_t mask;
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+};
+
+// Idle-core bitmap with per-core parking, so an enqueue wakes exactly one sleeping
+// core. Shared by every ready-queue type.
+class CoreParking {
+public:
+    void configure(uint32_t cores);
+
+    // Blocks the core until it is woken, stop is set, or a short timeout. hasWork is
+    // re-checked after the core is marked idle so a racing enqueue is never lost, and
+    // again after a notify to count wake-ups that found the queue already empty.
+    template <class HasWork>
+    void park(int coreId, const std::atomic<bool>& stop, HasWork hasWork) {
+        setIdle(coreId, true);
+        if (!hasWork() && !stop) {
+            if (sleep(coreId, stop) && !stop && !hasWork()) recordEmptyWakeup();
+        }
+        setIdle(coreId, false);
+    }
+
+    bool wakeOne();     // false when no core was idle
+    bool isIdle(uint32_t coreId) const;
+    bool wakeCore(uint32_t coreId);     // false when that core was not idle
+    void wakeAll();
+
+private:
+    struct alignas(64) Slot {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool notified = false;
+        uint64_t notifiedAt = 0;    // monotonicNanos() of the first pending notify
+    };
+
+    bool sleep(int coreId, const std::atomic<bool>& stop);     // true when notified
+    void notify(uint32_t coreId);
+    void setIdle(uint32_t coreId, bool idle);
+
+    uint32_t numCores = 0;
+    std::unique_ptr<Slot[]> slots;
+    std::unique_ptr<std::atomic<uint64_t>[]> idleMask;
+    size_t idleWords = 0;
+};
+
+class RunQueues {
+public:
+    void configure(uint32_t cores);
+
+    void inject(Process* proc);
+    // Appends a whole batch under one lock and wakes up to count idle cores.
+    void injectBatch(Process* const* procs, size_t count);
+    void requeue(int coreId, Process* proc);
+    // Soft affinity: hands proc to the core it last ran on if that core is idle, so it
+    // runs where its program may still be cached; otherwise the same as inject().
+    void injectAffine(Process* proc);
+    Process* next(int coreId);
+
+    // Moves every queued process into out; used when the scheduler is replaced.
+    void drain(std::vector<Process*>& out);
+
+    // Blocks the core until it is woken by an enqueue, stop is set, or a short timeout.
+    void park(int coreId, const std::atomic<bool>& stop);
+    void wakeAll();
+
+private:
+    struct alignas(64) CoreSlot {
+        WorkStealingDeque local;
+        uint32_t dispatches = 0;
+        std::mutex inboxMutex;
+        std::deque<Process*> inbox;
+        std::atomic<size_t> inboxSize{0};
+    };
+
+    bool hasWork() const;
+    Process* popInbox(CoreSlot& slot);
+    Process* popGlobal();
+    Process* stealFrom(int thief);
+
+    uint32_t numCores = 0;
+    std::unique_ptr<CoreSlot[]> slots;
+    CoreParking parking;
+
+    std::deque<Process*> global;
+    std::mutex globalMutex;
+    std::atomic<size_t> globalSize{0};
+};
+
+// Which processes PriorityRunQueue hands out first.
+enum class ReadyOrder {
+    SHORTEST_REMAINING,     // fewest remaining instructions
+    ARRIVAL                 // earliest ProcessTimes::arrivedAt, so wakers keep their place
+};
+
+// Ready set shared by all cores and ordered by a key, smallest first; equal keys keep
+// the order they were pushed in. One lock guards the heap and is taken once per enqueue
+// or dispatch. The smallest queued key is also published atomically, so a running core
+// can check for a shorter job without locking.
+class PriorityRunQueue {
+public:
+    void configure(uint32_t cores, ReadyOrder order = ReadyOrder::SHORTEST_REMAINING);
+
+    void push(Process* proc);
+    void pushBatch(Process* const* procs, size_t count);
+    Process* pop();
+
+    // Key of the best queued process; UINT64_MAX when empty.
+    uint64_t bestKey() const { return best.load(std::memory_order_acquire); }
+
+    void drain(std::vector<Process*>& out);
+    void park(int coreId, const std::atomic<bool>& stop);
+    void wakeAll();
+
+    // Remaining instructions, the SHORTEST_REMAINING key.
+    static uint64_t keyOf(const Process& proc);
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t seq;
+        Process* proc;
+    };
+
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.key != b.key ? a.key > b.key : a.seq > b.seq;
+        }
+    };
+
+    void pushLocked(Process* proc);
+    void publishBest();
+
+    std::vector<Entry> heap;
+    std::mutex mutex;
+    uint64_t seq = 0;
+    ReadyOrder order = ReadyOrder::SHORTEST_REMAINING;
+    std::atomic<uint64_t> best{UINT64_MAX};
+    CoreParking parking;
+};
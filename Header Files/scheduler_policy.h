@@ -0,0 +1,228 @@
+/*
+scheduler_policy.h
+
+Declares the scheduling policies and the interface they share. A policy owns the ready
+queue and makes every scheduling decision: which process a core runs next, how many
+steps it may run, and where it goes when it stops. A process that stops at a SLEEP
+leaves the core for CoreManager's timer wheel and comes back through onWake().
+CoreManager's core loop and the simulator are templates instantiated once per policy,
+so the hooks below are resolved at compile time and the hot path makes no string
+compares or virtual calls.
+
+A policy class provides:
+    static constexpr const char* NAME;          value of the `scheduler` config key
+    void configure(uint32_t cores, const Config& config);
+    void onArrival(Process* const* procs, size_t count);    new processes become ready
+    Process* selectNext(int coreId);                       nullptr when nothing is ready
+    uint32_t quantum(const Process& proc) const;            steps per dispatch
+    bool shouldPreempt(const Process& proc) const;          at quantum expiry; false runs another
+    void onQuantumExpiry(int coreId, Process* proc);      preempted, still ready
+    void onWake(Process* proc);                           SLEEP expired, ready again
+    void onStop(int coreId, Process* proc);               scheduler stopped mid-slice; requeue as it was
+    void onFinish(int coreId, Process* proc);
+    void onTick(uint64_t tick);                             CPU clock (virtual in --simulate)
+    void park(int coreId, const std::atomic<bool>& stop);   idle core waits for work
+    void wakeAll();
+    void drain(std::vector<Process*>& out);                 hand over queued processes
+
+To add a policy, write the class and list it in withPolicy().
+*/
+
+#pragma once
+
+#include "config.h"
+#include "run_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Process;
+
+// quantum() value for policies that never preempt.
+const uint32_t UNLIMITED_QUANTUM = std::numeric_limits<uint32_t>::max();
+
+// Runs each process until it finishes or sleeps, in arrival order. A process woken from
+// a SLEEP goes back ahead of every process that arrived after it, rather than to the
+// tail as under rr, so the ready queue is ordered by arrival time.
+class FcfsPolicy {
+public:
+    static constexpr const char* NAME = "fcfs";
+
+    void configure(uint32_t cores, const Config&) { queue.configure(cores, ReadyOrder::ARRIVAL); }
+    void onArrival(Process* const* procs, size_t count) { queue.pushBatch(procs, count); }
+    Process* selectNext(int) { return queue.pop(); }
+    uint32_t quantum(const Process&) const { return UNLIMITED_QUANTUM; }
+    bool shouldPreempt(const Process&) const { return true; }
+    void onQuantumExpiry(int, Process* proc) { queue.push(proc); }
+    void onWake(Process* proc) { queue.push(proc); }
+    void onStop(int, Process* proc) { queue.push(proc); }
+    void onFinish(int, Process*) {}
+    void onTick(uint64_t) {}
+    void park(int coreId, const std::atomic<bool>& stop) { queue.park(coreId, stop); }
+    void wakeAll() { queue.wakeAll(); }
+    void drain(std::vector<Process*>& out) { queue.drain(out); }
+
+private:
+    PriorityRunQueue queue;
+};
+
+// FIFO order with a fixed quantum of quantum-cycles steps per dispatch.
+class RoundRobinPolicy {
+public:
+    static constexpr const char* NAME = "rr";
+
+    void configure(uint32_t cores, const Config& config) {
+        queues.configure(cores);
+        quantumCycles = std::max<uint32_t>(1, config.quantumCycles);
+    }
+    void onArrival(Process* const* procs, size_t count) { queues.injectBatch(procs, count); }
+    Process* selectNext(int coreId) { return queues.next(coreId); }
+    uint32_t quantum(const Process&) const { return quantumCycles; }
+    bool shouldPreempt(const Process&) const { return true; }
+    void onQuantumExpiry(int coreId, Process* proc) { queues.requeue(coreId, proc); }
+    void onWake(Process* proc) { queues.injectAffine(proc); }
+    void onStop(int coreId, Process* proc) { queues.requeue(coreId, proc); }
+    void onFinish(int, Process*) {}
+    void onTick(uint64_t) {}
+    void park(int coreId, const std::atomic<bool>& stop) { queues.park(coreId, stop); }
+    void wakeAll() { queues.wakeAll(); }
+    void drain(std::vector<Process*>& out) { queues.drain(out); }
+
+private:
+    RunQueues queues;
+    uint32_t quantumCycles = 1;
+};
+
+// Runs the shortest job first, judged by remaining instructions, without preemption.
+class SjfPolicy {
+public:
+    static constexpr const char* NAME = "sjf";
+
+    void configure(uint32_t cores, const Config&) { queue.configure(cores); }
+    void onArrival(Process* const* procs, size_t count) { queue.pushBatch(procs, count); }
+    Process* selectNext(int) { return queue.pop(); }
+    uint32_t quantum(const Process&) const { return UNLIMITED_QUANTUM; }
+    bool shouldPreempt(const Process&) const { return true; }
+    void onQuantumExpiry(int, Process* proc) { queue.push(proc); }
+    void onWake(Process* proc) { queue.push(proc); }
+    void onStop(int, Process* proc) { queue.push(proc); }
+    void onFinish(int, Process*) {}
+    void onTick(uint64_t) {}
+    void park(int coreId, const std::atomic<bool>& stop) { queue.park(coreId, stop); }
+    void wakeAll() { queue.wakeAll(); }
+    void drain(std::vector<Process*>& out) { queue.drain(out); }
+
+private:
+    PriorityRunQueue queue;
+};
+
+// Shortest remaining time first. Every PREEMPTION_CHECK_STEPS the running process is
+// compared with the best queued one and gives up the core if that is shorter.
+class SrtfPolicy {
+public:
+    static constexpr const char* NAME = "srtf";
+    static const uint32_t PREEMPTION_CHECK_STEPS = 64;
+
+    void configure(uint32_t cores, const Config&) { queue.configure(cores); }
+    void onArrival(Process* const* procs, size_t count) { queue.pushBatch(procs, count); }
+    Process* selectNext(int) { return queue.pop(); }
+    uint32_t quantum(const Process&) const { return PREEMPTION_CHECK_STEPS; }
+    bool shouldPreempt(const Process& proc) const { return queue.bestKey() < PriorityRunQueue::keyOf(proc); }
+    void onQuantumExpiry(int, Process* proc) { queue.push(proc); }
+    void onWake(Process* proc) { queue.push(proc); }
+    void onStop(int, Process* proc) { queue.push(proc); }
+    void onFinish(int, Process*) {}
+    void onTick(uint64_t) {}
+    void park(int coreId, const std::atomic<bool>& stop) { queue.park(coreId, stop); }
+    void wakeAll() { queue.wakeAll(); }
+    void drain(std::vector<Process*>& out) { queue.drain(out); }
+
+private:
+    PriorityRunQueue queue;
+};
+
+const uint32_t MLFQ_MAX_LEVELS = 8;
+// Queue entries MlfqPolicy looks past the head for a process last run on the asking core.
+const size_t MLFQ_AFFINITY_LOOKAHEAD = 4;
+
+// Multi-level feedback queue. New processes start at level 0; using up a quantum moves a
+// process down one level and waking from a SLEEP moves it up one. Level i runs with its
+// own quantum (mlfq-quanta, by default quantum-cycles << i), and every mlfq-boost ticks
+// all processes go back to level 0 so long jobs are not starved.
+class MlfqPolicy {
+public:
+    static constexpr const char* NAME = "mlfq";
+
+    void configure(uint32_t cores, const Config& config);
+    void onArrival(Process* const* procs, size_t count);
+    Process* selectNext(int coreId);
+    uint32_t quantum(const Process& proc) const;
+    bool shouldPreempt(const Process&) const { return true; }
+    void onQuantumExpiry(int coreId, Process* proc);
+    void onWake(Process* proc);
+    void onStop(int, Process* proc) { push(proc, 0); }
+    void onFinish(int, Process*) {}
+    void onTick(uint64_t tick);
+    void park(int coreId, const std::atomic<bool>& stop);
+    void wakeAll() { parking.wakeAll(); }
+    void drain(std::vector<Process*>& out);
+
+private:
+    struct Level {
+        std::mutex mutex;
+        std::deque<Process*> queue;
+        std::atomic<size_t> size{0};
+        uint32_t quantum = 1;
+    };
+
+    void push(Process* proc, int change);
+    void boost();
+    bool hasWork() const;
+
+    std::unique_ptr<Level[]> levels;
+    uint32_t levelCount = 1;
+    uint64_t boostInterval = 0;
+    uint64_t nextBoost = 0;
+    std::atomic<uint32_t> epoch{0};     // bumped by every boost
+    CoreParking parking;
+};
+
+template <class Policy>
+struct PolicyTag {
+    typedef Policy type;
+};
+
+// Calls f(PolicyTag<P>()) for the policy called name. Returns false if there is none.
+template <class F>
+bool withPolicy(const std::string& name, F&& f) {
+    if (name == FcfsPolicy::NAME) f(PolicyTag<FcfsPolicy>());
+    else if (name == RoundRobinPolicy::NAME) f(PolicyTag<RoundRobinPolicy>());
+    else if (name == SjfPolicy::NAME) f(PolicyTag<SjfPolicy>());
+    else if (name == SrtfPolicy::NAME) f(PolicyTag<SrtfPolicy>());
+    else if (name == MlfqPolicy::NAME) f(PolicyTag<MlfqPolicy>());
+    else return false;
+    return true;
+}
+
+// Type-erased handle CoreManager keeps for the configured policy. Only cold paths go
+// through it: each core thread calls run() once and stays in the policy's core loop.
+class Scheduler {
+public:
+    virtual ~Scheduler() = default;
+    virtual void admit(Process* const* procs, size_t count) = 0;
+    virtual void run(int coreId) = 0;
+    virtual void wakeAll() = 0;
+    virtual void wake(Process* const* procs, size_t count) = 0;
+    virtual void tick(uint64_t tick) = 0;
+    virtual void drain(std::vector<Process*>& out) = 0;
+};
+
+template <class Policy>
+class PolicyScheduler;
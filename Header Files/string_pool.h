@@ -0,0 +1,23 @@
+/*
+string_pool.h
+
+Declares the global string interning table used for instruction operands and PRINT
+messages. Each distinct string is stored once and referred to by a 32-bit StrId;
+numeric strings also carry their parsed uint16_t value.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+typedef uint32_t StrId;
+
+StrId internString(const std::string& text);
+const std::string& internedString(StrId id);
+
+// True when the string is a decimal constant; value receives its uint16_t conversion.
+bool internedNumber(StrId id, uint16_t& value);
+
+// Interned decimal form of value; 0-255 are pre-interned and need no lookup.
+StrId numberString(int value);
@@ -0,0 +1,42 @@
+/*
+timer_wheel.h
+
+Declares TimerWheel, the hashed timing wheel that holds sleeping processes off-core.
+A SLEEP of n ticks files the process into slot (now + n) % slots; each tick only the
+current slot is inspected, so scheduling and expiry are O(1) apart from timers that
+are due further than one revolution away and stay for another round.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class Process;
+
+const size_t TIMER_WHEEL_SLOTS = 256;
+
+class TimerWheel {
+public:
+    TimerWheel();
+
+    // Wakes proc after ticks more calls to advance() (at least one).
+    void schedule(Process* proc, uint64_t ticks);
+
+    // Moves the wheel one tick forward and appends every expired process to woken.
+    void advance(std::vector<Process*>& woken);
+
+    size_t size() const;
+
+private:
+    struct Timer {
+        uint64_t due;
+        Process* proc;
+    };
+
+    std::vector<std::vector<Timer>> slots;
+    uint64_t now = 0;
+    size_t count = 0;
+    mutable std::mutex mutex;
+};
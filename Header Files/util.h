@@ -8,9 +8,11 @@ and other helper utilities.
 #pragma once
 
 #include <string>
+#include <ctime>
 #include "screen.h"
 
 std::string getCurrentTimestamp();
+std::string formatTimestamp(std::time_t time);
 void printHeader();
 void clearScreen();
 void drawScreen(const ConsoleScreen& screen);
@@ -0,0 +1,369 @@
+/*
+bench.cpp
+
+Micro-benchmarks for the emulator's hot paths, built as a separate executable that
+links every source file except main.cpp. Each benchmark is timed over several
+repeats and reported as one CSV row, so the output can be diffed or loaded between
+builds:
+
+    benchmark,unit,units,repeats,min_ns_per_unit,median_ns_per_unit
+
+--scaling instead runs one fixed seeded workload on the real core threads with 1, 2,
+4 ... --max-cores cores and delay-per-exec 0, one CSV row per core count:
+
+    cores,scheduler,processes,instructions,dispatches,preemptions,migrations,seconds,
+    instructions_per_sec,dispatches_per_sec,speedup,efficiency
+
+speedup is instructions/s relative to one core and efficiency is speedup / cores.
+
+Usage: bench [--repeats N] [--filter TEXT]
+       bench --scaling [--processes N] [--max-cores N] [--scheduler NAME] [--seed S]
+                       [--tick-us N]
+*/
+
+#include "core_manager.h"
+#include "clock_service.h"
+#include "instruction_add.h"
+#include "instruction_declare.h"
+#include "instruction_for.h"
+#include "instruction_print.h"
+#include "instruction_random.h"
+#include "instruction_subtract.h"
+#include "instruction_utils.h"
+#include "process.h"
+#include "scheduler_policy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint64_t BENCH_SEED = 42;
+const int EXEC_INSTRUCTIONS = 50000;
+const int EXEC_PASSES = 20;
+const int GENERATE_SIZE = 1000;
+const int GENERATE_ROUNDS = 2000;
+const int CONSTRUCT_COUNT = 2000;
+const int ADD_PROCESS_COUNT = 100000;
+const int DISPATCH_PROCESSES = 64;
+const int DISPATCH_ROUNDS = 1000000;
+const int SUMMARY_CALLS = 1000;
+const int SUMMARY_LIVE_PROCESSES = 64;       // one running per core, the rest queued
+const uint32_t SUMMARY_PACING_TICKS = 1000;  // one instruction per second at 1 ms ticks
+
+struct Options {
+    int repeats = 5;
+    std::string filter;
+    bool scaling = false;
+    uint64_t processes = 2000;
+    uint32_t maxCores = 64;
+    std::string scheduler = "rr";
+    uint64_t seed = BENCH_SEED;
+    uint32_t tickUs = 10;       // short ticks so SLEEPs do not dominate the run
+};
+
+Options options;
+
+bool selected(const std::string& name) {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+// Runs body `repeats` times. body does its own setup and returns the nanoseconds of
+// the timed part, so setup never counts; units is how many operations one run times.
+void bench(const std::string& name, const std::string& unit, uint64_t units,
+           const std::function<uint64_t()>& body) {
+    if (!selected(name)) return;
+    std::vector<double> perUnit;
+    for (int i = 0; i < options.repeats; ++i) perUnit.push_back(double(body()) / units);
+    std::sort(perUnit.begin(), perUnit.end());
+    std::cout << name << ',' << unit << ',' << units << ',' << options.repeats << ','
+              << std::fixed << std::setprecision(2) << perUnit.front() << ','
+              << perUnit[perUnit.size() / 2] << std::endl;
+}
+
+class Timer {
+public:
+    Timer() : start(std::chrono::steady_clock::now()) {}
+    uint64_t elapsed() const {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+Config benchConfig(const std::string& scheduler, uint32_t cores) {
+    Config config;
+    config.numCPU = cores;
+    config.schedulerType = scheduler;
+    config.quantumCycles = 5;
+    config.batchProcFreq = 1;
+    config.minIns = 100;
+    config.maxIns = 100;
+    config.delayPerExec = 0;
+    config.seed = BENCH_SEED;
+    return config;
+}
+
+// A program made only of one instruction type, or of FOR loops, about count long.
+InstructionSet mixProgram(const std::string& mix, int count) {
+    InstructionSet set;
+    Rng rng(BENCH_SEED);
+    for (int i = 0; i < 3; ++i) set.top.push_back(generateDeclare(variableId(i), 1));
+    int emitted = 3;
+    while (emitted < count) {
+        if (mix == "for") {
+            Instruction loop = generateFor(rng, set);
+            set.top.push_back(loop);
+            emitted += std::max(1, dynamicInstructionCount(set, loop));
+            continue;
+        }
+        if (mix == "declare") set.top.push_back(generateDeclare(variableId(0), rng.below(10)));
+        else if (mix == "add") set.top.push_back(generateAdd(rng, variableId(0)));
+        else if (mix == "subtract") set.top.push_back(generateSubtract(rng, variableId(0)));
+        else if (mix == "print") set.top.push_back(generatePrint());
+        ++emitted;
+    }
+    return set;
+}
+
+// executeNextInstruction() over a whole program, EXEC_PASSES times; SLEEP ticks in the
+// generated mix count as calls but not as instructions.
+void benchExecute() {
+    const char* mixes[] = {"declare", "add", "subtract", "print", "for", "generated"};
+    for (const char* mix : mixes) {
+        uint64_t executed = 0;
+        auto run = [&]() {
+            Process proc("bench", 0, 0, BENCH_SEED, DEFAULT_LOG_CAPACITY);
+            InstructionSet set;
+            if (std::string(mix) == "generated") generateInstructionSet(set, EXEC_INSTRUCTIONS, BENCH_SEED);
+            else set = mixProgram(mix, EXEC_INSTRUCTIONS);
+            proc.program = compileProgram(set);
+            proc.totalInstructions = 1 << 30;
+            Timer timer;
+            for (int pass = 0; pass < EXEC_PASSES; ++pass) {
+                proc.instructionPointer = 0;
+                while (proc.executeNextInstruction()) {}
+            }
+            uint64_t ns = timer.elapsed();
+            executed = uint64_t(proc.executedInstructions.load());
+            return ns;
+        };
+        run();      // sizes the unit count for the rows below
+        bench(std::string("execute/") + mix, "instruction", executed, run);
+    }
+}
+
+void benchGenerate() {
+    InstructionSet set;
+    bench("generate/1k", "1k instructions", GENERATE_ROUNDS, [&]() {
+        Timer timer;
+        for (int i = 0; i < GENERATE_ROUNDS; ++i) generateInstructionSet(set, GENERATE_SIZE, BENCH_SEED + i);
+        return timer.elapsed();
+    });
+    bench("generate+compile/1k", "1k instructions", GENERATE_ROUNDS, [&]() {
+        Timer timer;
+        for (int i = 0; i < GENERATE_ROUNDS; ++i) {
+            generateInstructionSet(set, GENERATE_SIZE, BENCH_SEED + i);
+            Program program = compileProgram(set);
+        }
+        return timer.elapsed();
+    });
+}
+
+void benchConstruct() {
+    const ProgramSource sources[] = {ProgramSource::EAGER, ProgramSource::STREAM};
+    const char* names[] = {"process/construct-eager-1k", "process/construct-stream-1k"};
+    for (int s = 0; s < 2; ++s) {
+        bench(names[s], "process", CONSTRUCT_COUNT, [&]() {
+            std::vector<std::unique_ptr<Process>> procs(CONSTRUCT_COUNT);
+            Timer timer;
+            for (int i = 0; i < CONSTRUCT_COUNT; ++i) {
+                procs[i].reset(new Process("process" + std::to_string(i), i, GENERATE_SIZE,
+                                           deriveSeed(BENCH_SEED, i), DEFAULT_LOG_CAPACITY, sources[s]));
+            }
+            return timer.elapsed();
+        });
+    }
+}
+
+// Processes with no program; only their bookkeeping is under test.
+std::vector<Process*> emptyProcesses(int count, int firstId) {
+    std::vector<Process*> procs(count);
+    for (int i = 0; i < count; ++i) {
+        procs[i] = new Process("process" + std::to_string(firstId + i), firstId + i, 0, 0,
+                               DEFAULT_LOG_CAPACITY, ProgramSource::STREAM);
+    }
+    return procs;
+}
+
+void benchAddProcess() {
+    const char* policies[] = {"fcfs", "rr", "sjf", "srtf", "mlfq"};
+    for (const char* policy : policies) {
+        bench(std::string("core-manager/add-process/") + policy, "process", ADD_PROCESS_COUNT, [&]() {
+            std::unique_ptr<CoreManager> manager(new CoreManager());
+            manager->configure(benchConfig(policy, 4));
+            std::vector<Process*> procs = emptyProcesses(ADD_PROCESS_COUNT, 0);
+            Timer timer;
+            for (Process* proc : procs) manager->addProcess(proc);
+            return timer.elapsed();
+        });
+    }
+}
+
+// One dispatch round-trip: select the next process, then hand it back as preempted,
+// with DISPATCH_PROCESSES circulating through the policy's ready queue on one core.
+void benchDispatch() {
+    const char* policies[] = {"fcfs", "rr", "sjf", "srtf", "mlfq"};
+    for (const char* name : policies) {
+        withPolicy(name, [&](auto tag) {
+            typedef typename decltype(tag)::type Policy;
+            bench(std::string("dispatch/round-trip/") + name, "dispatch", DISPATCH_ROUNDS, [&]() {
+                Policy policy;
+                policy.configure(1, benchConfig(name, 1));
+                std::vector<Process*> procs = emptyProcesses(DISPATCH_PROCESSES, 0);
+                policy.onArrival(procs.data(), procs.size());
+                Timer timer;
+                for (int i = 0; i < DISPATCH_ROUNDS; ++i) {
+                    Process* proc = policy.selectNext(0);
+                    policy.onQuantumExpiry(0, proc);
+                }
+                uint64_t ns = timer.elapsed();
+                std::vector<Process*> drained;
+                policy.drain(drained);
+                for (Process* proc : drained) delete proc;
+                return ns;
+            });
+        });
+    }
+}
+
+// screen -ls after a real run: size processes finished through runWorkload(), then a
+// long process running on every core with more queued behind them. Instructions are
+// paced to one a second, so the cores sit idle while the report is timed.
+void benchSummary() {
+    const int sizes[] = {10000, 100000};
+    const uint32_t cores = 4;
+    for (int size : sizes) {
+        std::string name = "report/print-process-summary/" + std::to_string(size / 1000) + "k";
+        if (!selected(name)) continue;
+        CoreManager manager;
+        Config config = benchConfig("rr", cores);
+        config.cpuTickUs = options.tickUs;
+        manager.configure(config);
+        manager.runWorkload(size);
+
+        config.cpuTickUs = 1000;
+        config.delayPerExec = SUMMARY_PACING_TICKS;
+        manager.configure(config);
+        std::vector<Process*> live(SUMMARY_LIVE_PROCESSES);
+        for (int i = 0; i < SUMMARY_LIVE_PROCESSES; ++i) {
+            int id = size + i;
+            live[i] = new Process("process" + std::to_string(id), id, 1000, deriveSeed(BENCH_SEED, id));
+        }
+        manager.start();
+        manager.addProcesses(live.data(), live.size());
+
+        std::ostringstream out;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        do {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            out.str(std::string());
+            manager.printProcessSummary(out, false);
+        } while (out.str().find("Cores available: 0") == std::string::npos && std::chrono::steady_clock::now() < deadline);
+
+        bench(name, "call", SUMMARY_CALLS, [&]() {
+            Timer timer;
+            for (int i = 0; i < SUMMARY_CALLS; ++i) {
+                out.str(std::string());
+                manager.printProcessSummary(out, false);
+            }
+            return timer.elapsed();
+        });
+        manager.haltCores();
+    }
+}
+
+void runScaling() {
+    // Core counts past the host's hardware threads only measure oversubscription.
+    std::cerr << "[INFO] Host hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    std::cout << "cores,scheduler,processes,instructions,dispatches,preemptions,migrations,seconds,"
+                 "instructions_per_sec,dispatches_per_sec,speedup,efficiency" << std::endl;
+    double baseline = 0;
+    for (uint32_t cores = 1; cores <= options.maxCores; cores *= 2) {
+        Config config = benchConfig(options.scheduler, cores);
+        config.minIns = 1000;
+        config.maxIns = 2000;
+        config.cpuTickUs = options.tickUs;
+        config.seed = options.seed;
+
+        CoreManager manager;
+        manager.configure(config);
+        WorkloadResult result = manager.runWorkload(options.processes);
+
+        double instructionRate = result.seconds > 0 ? result.instructions / result.seconds : 0.0;
+        double dispatchRate = result.seconds > 0 ? result.dispatches / result.seconds : 0.0;
+        if (cores == 1) baseline = instructionRate;
+        double speedup = baseline > 0 ? instructionRate / baseline : 0.0;
+        std::cout << cores << ',' << options.scheduler << ',' << result.processes << ','
+                  << result.instructions << ',' << result.dispatches << ',' << result.preemptions << ','
+                  << result.migrations << ','
+                  << std::fixed << std::setprecision(4) << result.seconds << ','
+                  << std::setprecision(0) << instructionRate << ',' << dispatchRate << ','
+                  << std::setprecision(3) << speedup << ',' << speedup / cores << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (flag == "--scaling") {
+            options.scaling = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "[ERROR] Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (flag == "--repeats") options.repeats = std::max(1, std::stoi(value));
+        else if (flag == "--filter") options.filter = value;
+        else if (flag == "--processes") options.processes = std::stoull(value);
+        else if (flag == "--max-cores") options.maxCores = std::max(1, std::stoi(value));
+        else if (flag == "--scheduler") options.scheduler = value;
+        else if (flag == "--seed") options.seed = std::stoull(value);
+        else if (flag == "--tick-us") options.tickUs = std::max(1, std::stoi(value));
+        else {
+            std::cerr << "[ERROR] Unknown option: " << flag << "\n";
+            return 1;
+        }
+    }
+
+    startClockService();
+    if (options.scaling) {
+        runScaling();
+        stopClockService();
+        return 0;
+    }
+    std::cout << "benchmark,unit,units,repeats,min_ns_per_unit,median_ns_per_unit" << std::endl;
+    benchExecute();
+    benchGenerate();
+    benchConstruct();
+    benchAddProcess();
+    benchDispatch();
+    benchSummary();
+    stopClockService();
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+bytecode.cpp
+
+Implements the lowering of generated instruction sets into bytecode: variable names
+become register slots, numeric arguments become immediates, PRINT keeps its interned
+message id, and FOR trees are flattened into LOOP_BEGIN/LOOP_END-delimited runs of ops.
+*/
+
+#include "bytecode.h"
+#include "process.h"
+
+#include <stdexcept>
+
+namespace {
+
+struct Compiler {
+    const InstructionSet& set;
+    Program& program;
+
+    Compiler(const InstructionSet& set, Program& program) : set(set), program(program) {}
+
+    uint16_t slotFor(StrId name) {
+        for (uint8_t i = 0; i < program.slotCount; ++i) {
+            if (program.slotNames[i] == name) return i;
+        }
+        if (program.slotCount >= MAX_REGISTERS) {
+            throw std::runtime_error("Program uses more than " + std::to_string(MAX_REGISTERS) + " variables");
+        }
+        program.slotNames[program.slotCount] = name;
+        return program.slotCount++;
+    }
+
+    static uint16_t constant(StrId arg) {
+        uint16_t v = 0;
+        internedNumber(arg, v);
+        return v;
+    }
+
+    // Resolves an ADD/SUBTRACT source operand, setting slotBit in flags for variables.
+    uint16_t source(StrId arg, uint8_t slotBit, uint8_t& flags) {
+        uint16_t v = 0;
+        if (internedNumber(arg, v)) return v;
+        flags |= slotBit;
+        return slotFor(arg);
+    }
+
+    void emit(const Instruction& ins, size_t depth) {
+        Op op = {Opcode::PRINT, 0, 0, 0, 0};
+        switch (ins.type) {
+            case InstructionType::PRINT:
+                op.code = Opcode::PRINT;
+                op.a = static_cast<uint16_t>(ins.args[0] & 0xFFFF);
+                op.b = static_cast<uint16_t>(ins.args[0] >> 16);
+                break;
+            case InstructionType::DECLARE:
+                op.code = Opcode::DECLARE;
+                op.dst = slotFor(ins.args[0]);
+                op.a = constant(ins.args[1]);
+                break;
+            case InstructionType::ADD:
+            case InstructionType::SUBTRACT:
+                op.code = ins.type == InstructionType::ADD ? Opcode::ADD : Opcode::SUBTRACT;
+                op.dst = slotFor(ins.args[0]);
+                op.a = source(ins.args[1], OPERAND_A_SLOT, op.flags);
+                op.b = source(ins.args[2], OPERAND_B_SLOT, op.flags);
+                break;
+            case InstructionType::SLEEP:
+                op.code = Opcode::SLEEP;
+                op.a = constant(ins.args[0]);
+                break;
+            case InstructionType::FOR:
+                emitLoop(ins, depth);
+                return;
+        }
+        program.code.push_back(op);
+    }
+
+    // Loops that can never execute a counted instruction are dropped entirely.
+    void emitLoop(const Instruction& ins, size_t depth) {
+        uint16_t repeats = constant(ins.args[0]);
+        if (repeats == 0 || ins.blockLen == 0) return;
+        if (depth >= MAX_LOOP_DEPTH) {
+            throw std::runtime_error("FOR nesting exceeds " + std::to_string(MAX_LOOP_DEPTH) + " levels");
+        }
+
+        size_t begin = program.code.size();
+        Op head = {Opcode::LOOP_BEGIN, 0, 0, repeats, 0};
+        program.code.push_back(head);
+        for (uint32_t i = 0; i < ins.blockLen; ++i) emit(set.nodes[ins.blockBegin + i], depth + 1);
+
+        if (program.code.size() == begin + 1) {
+            program.code.pop_back();
+            return;
+        }
+        Op tail = {Opcode::LOOP_END, 0, 0, 0, 0};
+        setOpTarget(tail, static_cast<uint32_t>(begin + 1));
+        program.code.push_back(tail);
+        setOpTarget(program.code[begin], static_cast<uint32_t>(program.code.size()));
+    }
+
+    // Exact op count, so the code vector is allocated once at its final size.
+    size_t countOps(const Instruction& ins) const {
+        if (ins.type != InstructionType::FOR) return 1;
+        size_t body = 0;
+        for (uint32_t i = 0; i < ins.blockLen; ++i) body += countOps(set.nodes[ins.blockBegin + i]);
+        return body + 2;
+    }
+};
+
+}
+
+void appendProgram(Program& program, const InstructionSet& instructions) {
+    Compiler compiler(instructions, program);
+    size_t ops = program.code.size();
+    for (const auto& ins : instructions.top) ops += compiler.countOps(ins);
+    program.code.reserve(ops);
+
+    for (const auto& ins : instructions.top) {
+        compiler.emit(ins, 0);
+    }
+}
+
+Program compileProgram(const InstructionSet& instructions) {
+    Program program;
+    appendProgram(program, instructions);
+    return program;
+}
@@ -0,0 +1,119 @@
+/*
+clock_service.cpp
+
+Implements the clock service. Formatted stamps live in a small ring of slots guarded
+by per-slot version counters (a seqlock): the refresher writes the slot after the
+published one and then flips the published index, and readers retry if the version
+changed while they were copying.
+*/
+
+#include "clock_service.h"
+#include "util.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const size_t STAMP_SLOTS = 4;
+
+struct Stamp {
+    std::atomic<uint64_t> version{0};
+    std::time_t epoch = 0;
+    char text[32] = {};
+};
+
+Stamp stamps[STAMP_SLOTS];
+std::atomic<size_t> published{0};
+std::atomic<bool> running{false};
+std::atomic<uint64_t> ticks{0};
+
+std::thread refresher;
+std::mutex refresherMutex;
+std::condition_variable refresherCond;
+
+void publish(std::time_t now) {
+    size_t next = (published.load(std::memory_order_relaxed) + 1) % STAMP_SLOTS;
+    Stamp& slot = stamps[next];
+    std::string text = formatTimestamp(now);
+
+    slot.version.fetch_add(1, std::memory_order_acq_rel);
+    slot.epoch = now;
+    std::strncpy(slot.text, text.c_str(), sizeof(slot.text) - 1);
+    slot.version.fetch_add(1, std::memory_order_release);
+    published.store(next, std::memory_order_release);
+}
+
+// Copies the published slot, retrying if the refresher rewrote it mid-read.
+void readStamp(std::time_t& epoch, char (&text)[32]) {
+    while (true) {
+        const Stamp& slot = stamps[published.load(std::memory_order_acquire)];
+        uint64_t before = slot.version.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        epoch = slot.epoch;
+        std::memcpy(text, slot.text, sizeof(text));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) == before) return;
+    }
+}
+
+void refreshLoop() {
+    using namespace std::chrono;
+    std::unique_lock<std::mutex> lock(refresherMutex);
+    while (running) {
+        auto now = system_clock::now();
+        publish(system_clock::to_time_t(now));
+        auto nextSecond = time_point_cast<seconds>(now) + seconds(1);
+        refresherCond.wait_until(lock, nextSecond, [] { return !running; });
+    }
+}
+
+}
+
+void startClockService() {
+    if (running.exchange(true)) return;
+    publish(std::time(nullptr));
+    refresher = std::thread(refreshLoop);
+}
+
+void stopClockService() {
+    {
+        std::lock_guard<std::mutex> lock(refresherMutex);
+        if (!running.exchange(false)) return;
+    }
+    refresherCond.notify_all();
+    if (refresher.joinable()) refresher.join();
+}
+
+std::string cachedTimestamp() {
+    if (!running.load(std::memory_order_acquire)) return formatTimestamp(std::time(nullptr));
+    std::time_t epoch;
+    char text[32];
+    readStamp(epoch, text);
+    return std::string(text);
+}
+
+std::time_t cachedEpochSeconds() {
+    if (!running.load(std::memory_order_acquire)) return std::time(nullptr);
+    std::time_t epoch;
+    char text[32];
+    readStamp(epoch, text);
+    return epoch;
+}
+
+uint64_t currentTick() {
+    return ticks.load(std::memory_order_acquire);
+}
+
+void advanceTick() {
+    ticks.fetch_add(1, std::memory_order_acq_rel);
+}
+
+uint64_t monotonicNanos() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
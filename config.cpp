@@ -12,6 +12,29 @@ from config.txt into a Config struct.
 #include <iomanip>
 #include <iostream>
 
+namespace {
+
+// Values may be written with or without surrounding double quotes.
+std::string unquote(const std::string& raw) {
+    if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') return raw.substr(1, raw.size() - 2);
+    return raw;
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+}
+
+// The rest of the line without surrounding whitespace, for values that may hold spaces.
+std::string restOfLine(std::istream& in) {
+    std::string rest;
+    std::getline(in >> std::ws, rest);
+    size_t end = rest.find_last_not_of(" \t\r");
+    return end == std::string::npos ? std::string() : rest.substr(0, end + 1);
+}
+
+}
+
 bool loadConfig(const std::string& filename, Config& config) {
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -29,21 +52,45 @@ bool loadConfig(const std::string& filename, Config& config) {
         else if (key == "scheduler") {
             std::string raw;
             iss >> raw;
-
-            // Remove surrounding quotes manually (if any)
-            if (!raw.empty() && raw.front() == '"' && raw.back() == '"') {
-                raw = raw.substr(1, raw.size() - 2);
-            }
-
-            std::transform(raw.begin(), raw.end(), raw.begin(), ::tolower);
-            config.schedulerType = raw;
-
+            config.schedulerType = lowercase(unquote(raw));
         }
         else if (key == "quantum-cycles") iss >> config.quantumCycles;
         else if (key == "batch-process-freq") iss >> config.batchProcFreq;
         else if (key == "min-ins") iss >> config.minIns;
         else if (key == "max-ins") iss >> config.maxIns;
         else if (key == "delay-per-exec") iss >> config.delayPerExec;
+        else if (key == "cpu-tick-us") iss >> config.cpuTickUs;
+        else if (key == "log-cap") iss >> config.logCapacity;
+        else if (key == "seed") iss >> config.seed;
+        else if (key == "mlfq-levels") iss >> config.mlfqLevels;
+        else if (key == "mlfq-boost") iss >> config.mlfqBoostTicks;
+        else if (key == "mlfq-quanta") {
+            config.mlfqQuanta.clear();
+            uint32_t quantum;
+            while (iss >> quantum) config.mlfqQuanta.push_back(quantum);
+        }
+        else if (key == "cpu-affinity") {
+            std::string raw;
+            iss >> raw;
+            raw = lowercase(unquote(raw));
+            config.cpuAffinityMap.clear();
+            if (raw == "off" || raw == "auto") {
+                config.cpuAffinity = raw;
+            } else {
+                // A list of host CPUs, one per simulated core: "cpu-affinity 0 2 4 6".
+                int cpu;
+                std::istringstream first(raw);
+                if (first >> cpu) config.cpuAffinityMap.push_back(cpu);
+                while (iss >> cpu) config.cpuAffinityMap.push_back(cpu);
+                config.cpuAffinity = "map";
+            }
+        }
+        else if (key == "log-archive") config.logArchive = unquote(restOfLine(iss));
+        else if (key == "program-source") {
+            std::string raw;
+            iss >> raw;
+            config.programSource = lowercase(unquote(raw));
+        }
     }
 
     return true;
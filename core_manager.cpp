@@ -1,51 +1,133 @@
 #include "core_manager.h"
 #include "process.h"
 #include "util.h"
+#include "clock_service.h"
+#include "cpu_affinity.h"
 
+#include <algorithm>
 #include <iostream>
 #include <random>
 #include <thread>
 #include <chrono>
 #include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <vector>
 #include <string>
 #include <fstream>
+#include <iomanip>
 
 static const char* ORANGE = "\033[38;5;208m";
 static const char* RESET = "\033[0m";
 
+// Steps an FCFS core runs between checks of the stop flag when there is no delay.
+static const uint32_t FCFS_CHUNK = 4096;
+
+// Longest the batch generator sleeps before rechecking its stop flag.
+static const auto GENERATOR_POLL = std::chrono::milliseconds(100);
+
+// How often runWorkload() checks whether the workload has finished.
+static const auto WORKLOAD_POLL = std::chrono::microseconds(200);
+
+template <class Policy>
+class PolicyScheduler : public Scheduler {
+public:
+    explicit PolicyScheduler(CoreManager& manager) : manager(manager) {
+        policy.configure(manager.numCores, manager.settings);
+    }
+
+    void admit(Process* const* procs, size_t count) override { policy.onArrival(procs, count); }
+    void run(int coreId) override { manager.coreLoop(policy, coreId); }
+    void wakeAll() override { policy.wakeAll(); }
+    void wake(Process* const* procs, size_t count) override {
+        for (size_t i = 0; i < count; ++i) policy.onWake(procs[i]);
+    }
+    void tick(uint64_t tick) override { policy.onTick(tick); }
+    void drain(std::vector<Process*>& out) override { policy.drain(out); }
+
+private:
+    CoreManager& manager;
+    Policy policy;
+};
+
 CoreManager::CoreManager() {
     stop.store(false);
-    cpuTicks.store(0);
     generating.store(false);
+    // screen -ls and report-util work before initialize, on the default single core.
+    resetCoreState();
 }
 
 CoreManager::~CoreManager() {
     stopScheduler();
     stopSchedulerThread();
-    for (auto* proc : allProcesses) {
-        delete proc;
+    processPool.stop();
+    registry.deleteAll();
+}
+
+void CoreManager::configure(const Config& config) {
+    // The generator, core and tick threads hold references into the scheduler, stats
+    // and runningOn replaced below, so they are joined first; running processes are
+    // requeued and carried over. scheduler-start brings the threads back.
+    stopSchedulerThread();
+    if (!cores.empty()) {
+        haltCores();
+        std::cout << "[INFO] Scheduler stopped for reconfiguration. All cores joined.\n";
+    }
+    // Pooled processes were built from the old settings.
+    processPool.stop();
+    settings = config;
+    numCores = config.numCPU;
+    schedulerType = config.schedulerType;
+    quantumCycles = std::max<uint32_t>(1, config.quantumCycles);
+    batchProcessFreq = config.batchProcFreq;
+    minIns = config.minIns;
+    maxIns = config.maxIns;
+    delayPerExec = config.delayPerExec;
+    logCapacity = config.logCapacity;
+    masterSeed = config.seed;
+    if (masterSeed == 0) {
+        std::random_device device;
+        masterSeed = (uint64_t(device()) << 32) | device();
+    }
+    if (config.programSource != "eager" && config.programSource != "stream") {
+        std::cerr << "[WARN] Unknown program-source '" << config.programSource << "', using eager.\n";
+        settings.programSource = "eager";
+    }
+    programSource = settings.programSource == "stream" ? ProgramSource::STREAM : ProgramSource::EAGER;
+    tickDuration = std::chrono::microseconds(std::max<uint32_t>(1, config.cpuTickUs));
+    if (delayPerExec > 0 && !delayEngine.isCalibrated()) delayEngine.calibrate();
+    corePinning = planCoreAffinity(config, numCores);
+    metrics.clear(MetricUnit::NANOS, monotonicNanos());
+    resetCoreState();
+
+    if (config.logArchive.empty()) logArchive.close();
+    else logArchive.open(config.logArchive);
+
+    // Anything still queued moves over to the new policy.
+    std::vector<Process*> pending;
+    if (scheduler) scheduler->drain(pending);
+
+    bool known = withPolicy(schedulerType, [&](auto tag) {
+        scheduler.reset(new PolicyScheduler<typename decltype(tag)::type>(*this));
+    });
+    if (!known) {
+        std::cerr << "[WARN] Unknown scheduler '" << schedulerType << "', using fcfs.\n";
+        schedulerType = settings.schedulerType = FcfsPolicy::NAME;
+        scheduler.reset(new PolicyScheduler<FcfsPolicy>(*this));
     }
+    scheduler->admit(pending.data(), pending.size());
 }
 
-void CoreManager::configure(uint32_t coresCount, const std::string& schedType, uint32_t quantum,
-                            uint32_t batchFreq, uint32_t minI, uint32_t maxI, uint32_t delay) {
-    numCores = coresCount;
-    schedulerType = schedType;
-    quantumCycles = std::max<uint32_t>(1, quantum);
-    batchProcessFreq = batchFreq;
-    minIns = minI;
-    maxIns = maxI;
-    delayPerExec = delay;
-    coreBusy.assign(numCores, false);
-    coreInstructions.assign(numCores, 0);
+// Per-core arrays sized to numCores; only called while no core thread runs.
+void CoreManager::resetCoreState() {
+    coreStats.reset(numCores);
+    latencyStats.reset(numCores);
+    runningOn.reset(new std::atomic<Process*>[numCores]);
+    for (uint32_t i = 0; i < numCores; ++i) runningOn[i].store(nullptr);
+    runningLocks.reset(new std::mutex[numCores]);
+    busyCores.store(0);
 }
 
 void CoreManager::start() {
     stop = false;
-    cpuTicks.store(0);
 
     for (auto& t : cores) {
         if (t.joinable()) t.join();
@@ -59,15 +141,22 @@ void CoreManager::start() {
     tickThread = std::thread(&CoreManager::tickLoop, this);
 }
 
-void CoreManager::stopScheduler() {
+void CoreManager::haltCores() {
     stop = true;
-    queueCond.notify_all();
+    scheduler->wakeAll();
 
     for (auto& t : cores) {
         if (t.joinable()) t.join();
     }
+    cores.clear();
 
     if (tickThread.joinable()) tickThread.join();
+}
+
+void CoreManager::stopScheduler() {
+    if (cores.empty()) return;
+
+    haltCores();
 
     std::cout << "\n[INFO] Scheduler stopped. All cores joined.\n\n";
     std::this_thread::sleep_for(std::chrono::seconds(2));
@@ -77,136 +166,291 @@ void CoreManager::stopScheduler() {
 
 void CoreManager::startSchedulerThread(const Config& config) {
     if (generating.load()) return;
+    // A generator that stopped on an error has exited but was never joined.
+    if (schedulerThread.joinable()) schedulerThread.join();
 
+    try {
+        ensureProcessPool();
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Batch process generation not started: " << e.what() << "\n";
+        return;
+    }
     generating = true;
     schedulerThread = std::thread([this, config] {
         try {
+            // batch-process-freq is in CPU ticks. Arrivals that fall due while the thread
+            // sleeps are taken from the pool and enqueued together as one batch.
+            const auto interval = tickDuration * std::max<uint32_t>(1, config.batchProcFreq);
+            Process* batch[PROCESS_POOL_CAPACITY];
+            auto nextArrival = std::chrono::steady_clock::now();
             while (generating) {
-                std::string pname = "process" + std::to_string(processCounter);
-                std::uniform_int_distribution<uint32_t> dist(config.minIns, config.maxIns);
-                int numIns = dist(rng);
-                auto* proc = new Process(pname, processCounter++, numIns);
-                addProcess(proc);
-                std::this_thread::sleep_for(std::chrono::seconds(config.batchProcFreq));
+                auto now = std::chrono::steady_clock::now();
+                size_t due = 0;
+                while (nextArrival <= now && due < PROCESS_POOL_CAPACITY) {
+                    ++due;
+                    nextArrival += interval;
+                }
+                while (due > 0) {
+                    size_t taken = processPool.takeBatch(batch, due);
+                    addProcesses(batch, taken);
+                    due -= taken;
+                }
+                std::this_thread::sleep_until(std::min(nextArrival, std::chrono::steady_clock::now() + GENERATOR_POLL));
             }
         } catch (const std::exception& e) {
-            std::cerr << "[Scheduler Error] " << e.what() << "\n";
+            // Clearing the flag lets the next scheduler-start restart the pool and this thread.
+            generating = false;
+            std::cerr << "[Scheduler Error] " << e.what() << "; batch process generation stopped.\n";
         }
     });
     std::cout << "[INFO] Batch process generation started.\n";
 }
 
 void CoreManager::stopSchedulerThread() {
-    if (!generating.load()) return;
-    generating = false;
+    bool wasGenerating = generating.exchange(false);
     if (schedulerThread.joinable()) schedulerThread.join();
-    std::cout << "[INFO] Batch process generation stopped.\n";
+    if (wasGenerating) std::cout << "[INFO] Batch process generation stopped.\n";
+}
+
+WorkloadResult CoreManager::runWorkload(uint64_t processCount) {
+    std::vector<Process*> procs(processCount);
+    for (uint64_t i = 0; i < processCount; ++i) {
+        procs[i] = createProcess("process" + std::to_string(i), int(i));
+    }
+
+    // Counters run from configure(), so only this run's share is reported.
+    std::vector<CoreSample> before(coreStats.size());
+    for (uint32_t core = 0; core < coreStats.size(); ++core) before[core] = coreStats.total(core);
+
+    uint64_t finishedBefore = finished.total();
+    start();
+    auto begin = std::chrono::steady_clock::now();
+    addProcesses(procs.data(), procs.size());
+    while (finished.total() - finishedBefore < processCount) {
+        std::this_thread::sleep_for(WORKLOAD_POLL);
+    }
+    auto end = std::chrono::steady_clock::now();
+    haltCores();
+
+    WorkloadResult result;
+    result.processes = processCount;
+    result.seconds = std::chrono::duration<double>(end - begin).count();
+    for (uint32_t core = 0; core < coreStats.size(); ++core) {
+        CoreSample total = coreStats.total(core);
+        result.instructions += total.instructions - before[core].instructions;
+        result.dispatches += total.dispatches - before[core].dispatches;
+        result.preemptions += total.preemptions - before[core].preemptions;
+        result.migrations += total.migrations - before[core].migrations;
+    }
+    return result;
 }
 
 void CoreManager::addProcess(Process* proc) {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    readyQueue.push(proc);
-    allProcesses.push_back(proc);
-    queueCond.notify_one();
+    addProcesses(&proc, 1);
 }
 
-void CoreManager::reportUtil() {
-    std::cout << "\n=== CPU Utilization Report ===\n";
-    for (uint32_t i = 0; i < numCores; ++i) {
-        std::cout << "Core " << i << ": " << coreInstructions[i] << " instructions executed.\n";
+void CoreManager::addProcesses(Process* const* procs, size_t count) {
+    registry.addBatch(procs, count);
+    uint64_t nanos = monotonicNanos();
+    for (size_t i = 0; i < count; ++i) {
+        procs[i]->times.arrive(nanos);
+        procs[i]->state = ProcessState::QUEUED;
     }
-    std::cout << "===============================\n\n";
+    queuedCount.fetch_add(count);
+    scheduler->admit(procs, count);
 }
 
+// Live processes in id order. Lines are built under the registry's locks, which a
+// finishing process must also take before it can be deleted.
 void CoreManager::listProcessStatus() {
+    std::vector<std::pair<int, std::string>> lines;
+    registry.forEach([&](const Process* proc) {
+        ProcessState state = proc->state.load();
+        std::string status = state == ProcessState::FINISHED ? "Finished"
+                           : state == ProcessState::RUNNING ? "Running"
+                           : state == ProcessState::SLEEPING ? "Sleeping" : "Queued";
+        lines.emplace_back(proc->id, proc->name + "  | " + status
+                           + "  | Core " + std::to_string(proc->assignedCore)
+                           + "  | " + std::to_string(proc->executedInstructions) + " / " + std::to_string(proc->totalInstructions)
+                           + "  | " + proc->timestamp);
+    });
+    std::sort(lines.begin(), lines.end());
+
     std::cout << "\n--- Process Status ---\n\n";
-    for (const auto& proc : allProcesses) {
-        std::string status = proc->isFinished() ? "Finished" : (proc->assignedCore == -1 ? "Queued" : "Running");
-        std::cout << proc->name << "  | " << status
-                  << "  | Core " << proc->assignedCore
-                  << "  | " << proc->executedInstructions << " / " << proc->totalInstructions
-                  << "  | " << proc->timestamp << "\n";
-    }
+    for (const auto& line : lines) std::cout << line.second << "\n";
     std::cout << "\n------------------------\n\n";
 }
 
 void CoreManager::tickLoop() {
+    auto nextTick = std::chrono::steady_clock::now();
+    auto nextSample = nextTick + std::chrono::seconds(1);
+    std::vector<Process*> woken;
+    coreStats.recordSecond();
     while (!stop) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        cpuTicks.fetch_add(1);
-        queueCond.notify_all();
+        nextTick += tickDuration;
+        std::this_thread::sleep_until(nextTick);
+        advanceTick();
+
+        if (nextTick >= nextSample) {
+            coreStats.recordSecond();
+            nextSample += std::chrono::seconds(1);
+        }
+
+        sleepers.advance(woken);
+        if (!woken.empty()) {
+            wakeProcesses(woken);
+            woken.clear();
+        }
+        scheduler->tick(currentTick());
     }
 }
 
-void CoreManager::busyWait(uint32_t milliseconds) {
-    using clock = std::chrono::high_resolution_clock;
-    auto start = clock::now();
-    if (milliseconds == 0) milliseconds = 1;
-    while (true) {
-        auto now = clock::now();
-        if (std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() >= milliseconds) break;
-        for (volatile int i = 0; i < 1000; ++i);
+void CoreManager::wakeProcesses(const std::vector<Process*>& procs) {
+    uint64_t nanos = monotonicNanos();
+    for (Process* proc : procs) {
+        proc->times.ready(nanos);
+        proc->state = ProcessState::QUEUED;
     }
+    queuedCount.fetch_add(procs.size());
+    scheduler->wake(procs.data(), procs.size());
 }
 
 void CoreManager::coreWorker(int coreId) {
-    while (!stop) {
-        Process* proc = nullptr;
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            queueCond.wait(lock, [&] { return stop || !readyQueue.empty(); });
-
-            if (stop && readyQueue.empty()) {
-                coreBusy[coreId] = false;
-                return;
-            }
+    if (!corePinning.empty() && !pinCurrentThread(corePinning[coreId])) {
+        std::cerr << "[WARN] Could not pin core " << coreId << " to host CPU " << corePinning[coreId] << ".\n";
+    }
+    scheduler->run(coreId);
+}
 
-            proc = readyQueue.front();
-            readyQueue.pop();
-            proc->assignedCore = coreId;
-            coreBusy[coreId] = true;
+template <class Policy>
+void CoreManager::coreLoop(Policy& policy, int coreId) {
+    const std::chrono::nanoseconds execDelay = tickDuration * delayPerExec;
+    // With a delay every instruction is paced individually; otherwise a whole slice
+    // (or an FCFS chunk, so stop is still noticed) runs in one call.
+    const uint32_t stepLimit = execDelay.count() > 0 ? 1 : FCFS_CHUNK;
 
-            if (proc->timestamp.empty()) {
-                proc->timestamp = getCurrentTimestamp();
-            }
-        }
+    CoreCounters& counters = coreStats.core(coreId);
+    CoreLatency& latency = latencyStats.core(coreId);
+    setThreadLatency(&latency);
 
-        int remainingQuantum = quantumCycles;
-        while (!proc->isFinished() && (schedulerType == "fcfs" || (schedulerType == "rr" && remainingQuantum-- > 0))) {
-            if (stop) return;
-            busyWait(delayPerExec);
-            proc->executeNextInstruction();
-            ++coreInstructions[coreId];
+    while (!stop) {
+        Process* proc = policy.selectNext(coreId);
+        if (!proc) {
+            policy.park(coreId, stop);
+            continue;
         }
 
-        if (schedulerType == "rr" && !proc->isFinished()) {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            readyQueue.push(proc);
-            queueCond.notify_one();
+        uint64_t dispatchedAt = monotonicNanos();
+        latency[LatencyKind::DISPATCH].record(dispatchedAt - proc->times.readySince);
+        if (proc->assignedCore >= 0 && proc->assignedCore != coreId) bumpCounter(counters.migrations);
+        proc->assignedCore = coreId;
+        proc->times.dispatch(dispatchedAt);
+        proc->state = ProcessState::RUNNING;
+        queuedCount.fetch_sub(1);
+        runningOn[coreId].store(proc);
+        busyCores.fetch_add(1);
+        bumpCounter(counters.dispatches);
+
+        uint32_t remainingQuantum = policy.quantum(*proc);
+        uint32_t executed = 0;
+        SliceStop reason = SliceStop::STOPPED;
+        // Busy time is credited after every step rather than once per slice, so a long
+        // slice shows up in the seconds it actually ran in.
+        uint64_t creditedAt = dispatchedAt;
+        while (!stop) {
+            if (execDelay.count() > 0) delayEngine.waitFor(execDelay);
+            SliceResult slice = proc->runSlice(std::min(remainingQuantum, stepLimit));
+            uint64_t steppedAt = monotonicNanos();
+            bumpCounter(counters.busyNanos, steppedAt - creditedAt);
+            creditedAt = steppedAt;
+            executed += slice.executed;
+            if (slice.reason == SliceStop::FINISHED || slice.reason == SliceStop::SLEEP) {
+                reason = slice.reason;
+                break;
+            }
+            if (remainingQuantum != UNLIMITED_QUANTUM && (remainingQuantum -= slice.steps) == 0) {
+                if (policy.shouldPreempt(*proc)) {
+                    reason = SliceStop::QUANTUM_EXPIRED;
+                    break;
+                }
+                remainingQuantum = policy.quantum(*proc);
+            }
+        }
+        bumpCounter(counters.instructions, executed);
+        uint64_t releasedAt = creditedAt;
+        latency[LatencyKind::SLICE].record(releasedAt - dispatchedAt);
+        proc->times.release(releasedAt);
+
+        runningOn[coreId].store(nullptr);
+        busyCores.fetch_sub(1);
+        if (reason == SliceStop::FINISHED) {
+            proc->finishedAt = cachedEpochSeconds();
+            proc->times.finish(releasedAt);
+            metrics.record(*proc);
+            if (logArchive.isOpen()) logArchive.append(*proc);
+            proc->compact();
+            proc->state = ProcessState::FINISHED;
+            finished.append(*proc);
+            policy.onFinish(coreId, proc);
+            if (registry.retire(proc)) {
+                // Waits out any report still reading this process through runningOn.
+                { std::lock_guard<std::mutex> lock(runningLocks[coreId]); }
+                delete proc;
+            }
+        } else if (reason == SliceStop::SLEEP) {
+            // The wheel counts the sleep instead of the core; the tick thread requeues it.
+            uint64_t ticks = static_cast<uint64_t>(proc->sleepTicks);
+            proc->sleepTicks = 0;
+            proc->state = ProcessState::SLEEPING;
+            sleepers.schedule(proc, ticks);
+        } else if (reason == SliceStop::STOPPED) {
+            // Not a preemption: the process goes back as it was, with no demotion.
+            proc->state = ProcessState::QUEUED;
+            queuedCount.fetch_add(1);
+            proc->times.ready(releasedAt);
+            policy.onStop(coreId, proc);
+        } else {
+            proc->state = ProcessState::QUEUED;
+            queuedCount.fetch_add(1);
+            bumpCounter(counters.preemptions);
+            proc->times.preempt(releasedAt);
+            policy.onQuantumExpiry(coreId, proc);
         }
-
-        coreBusy[coreId] = false;
     }
+    setThreadLatency(nullptr);
 }
 
-Process* CoreManager::getProcessByName(const std::string& name) {
-    for (auto* p : allProcesses) {
-        if (p->name == name) return p;
-    }
-    return nullptr;
+bool CoreManager::hasProcess(const std::string& name) const {
+    return registry.containsName(name);
+}
+
+Process* CoreManager::attachProcess(const std::string& name) {
+    return registry.pinByName(name);
+}
+
+void CoreManager::detachProcess(Process* proc) {
+    if (registry.unpin(proc)) delete proc;
 }
 
 Process* CoreManager::spawnNewNamedProcess(const std::string& name) {
-    std::uniform_int_distribution<uint32_t> dist(minIns, maxIns);
-    int numIns = dist(rng);
-    Process* proc = new Process(name, processCounter++, numIns);
+    Process* proc = nullptr;
+    try {
+        ensureProcessPool();
+        // Programs never embed the process name, so a pooled process can take any name.
+        proc = processPool.take();
+    } catch (const std::exception& e) {
+        std::cerr << "\n[ERROR] Could not create process '" << name << "': " << e.what() << "\n";
+        return nullptr;
+    }
+    proc->name = name;
+    // Pinned before it is admitted, since it may finish before the screen opens.
+    registry.pin(proc);
     addProcess(proc);
     return proc;
 }
 
-void CoreManager::printProcessSummary(std::ostream& out, bool colorize) {
-    int usedCores = 0;
-    for (bool b : coreBusy) if (b) ++usedCores;
+void CoreManager::printProcessSummary(std::ostream& out, bool colorize, size_t finishedLimit) {
+    int usedCores = static_cast<int>(busyCores.load());
     int availableCores = numCores - usedCores;
     int percent = (numCores > 0) ? int((usedCores * 100.0) / numCores + 0.5) : 0;
 
@@ -221,37 +465,144 @@ void CoreManager::printProcessSummary(std::ostream& out, bool colorize) {
     out << "\n----------------------------------------\n";
 
     out << "\nRunning processes:\n\n";
-    for (const auto& proc : allProcesses) {
-        if (!proc->isFinished()) {
-            out << proc->name << "  ";
-            printColoredTimestamp(out, proc->timestamp);
-            out << "  Core: ";
-            outc(std::to_string(proc->assignedCore), ORANGE);
-            out << "  ";
-            outc(std::to_string(proc->executedInstructions), ORANGE);
-            out << " / ";
-            outc(std::to_string(proc->totalInstructions), ORANGE);
-            out << "\n";
-        }
+    for (uint32_t core = 0; core < numCores; ++core) {
+        std::lock_guard<std::mutex> lock(runningLocks[core]);
+        const Process* proc = runningOn[core].load();
+        if (!proc) continue;
+        out << proc->name << "  ";
+        printColoredTimestamp(out, proc->timestamp);
+        out << "  Core: ";
+        outc(std::to_string(core), ORANGE);
+        out << "  ";
+        outc(std::to_string(proc->executedInstructions), ORANGE);
+        out << " / ";
+        outc(std::to_string(proc->totalInstructions), ORANGE);
+        out << "\n";
     }
 
-    out << "\nFinished processes:\n\n";
-    for (const auto& proc : allProcesses) {
-        if (proc->isFinished()) {
-            out << proc->name << "  ";
-            printColoredTimestamp(out, proc->timestamp);
-            out << "  Finished  ";
-            outc(std::to_string(proc->totalInstructions), ORANGE);
-            out << " / ";
-            outc(std::to_string(proc->totalInstructions), ORANGE);
-            out << "\n";
+    out << "\nQueued processes: ";
+    outc(std::to_string(queuedCount.load()), ORANGE);
+    out << "\nSleeping processes: ";
+    outc(std::to_string(sleepers.size()), ORANGE);
+    out << "\n";
+
+    uint64_t finishedCount = finished.total();
+    std::vector<ProcessSummary> recent = finished.latest(finishedLimit);
+    out << "\nFinished processes (last " << recent.size() << " of " << finishedCount << "):\n\n";
+    for (const ProcessSummary& summary : recent) {
+        out << summary.name << "  ";
+        printColoredTimestamp(out, summary.timestamp);
+        out << "  Finished  ";
+        outc(std::to_string(summary.totalInstructions), ORANGE);
+        out << " / ";
+        outc(std::to_string(summary.totalInstructions), ORANGE);
+        out << "\n";
+    }
+
+    out << "\n----------------------------------------\n\n";
+}
+
+void CoreManager::printCoreUtilization(std::ostream& out) {
+    static const size_t WINDOWS[] = {1, 10, 60};
+    auto percent = [](const CoreSample& sample) { return 100.0 * busyShare(sample); };
+    auto millis = [](uint64_t nanos) { return nanos / 1000000; };
+    auto idleNanos = [](const CoreSample& sample) {
+        return sample.elapsedNanos > sample.busyNanos ? sample.elapsedNanos - sample.busyNanos : 0;
+    };
+
+    out << "Per-core utilization:\n\n";
+    out << std::left << std::setw(8) << "Core" << std::right
+        << std::setw(12) << "Busy ms" << std::setw(12) << "Idle ms"
+        << std::setw(14) << "Instructions" << std::setw(12) << "Dispatches"
+        << std::setw(13) << "Preemptions" << std::setw(12) << "Migrations";
+    for (size_t seconds : WINDOWS) out << std::setw(9) << ("last " + std::to_string(seconds) + "s");
+    out << "\n";
+
+    CoreSample all;
+    CoreSample allWindows[3];
+    size_t covered[3] = {};
+    out << std::fixed << std::setprecision(1);
+    for (uint32_t core = 0; core < coreStats.size(); ++core) {
+        CoreSample total = coreStats.total(core);
+        out << std::left << std::setw(8) << core << std::right
+            << std::setw(12) << millis(total.busyNanos) << std::setw(12) << millis(idleNanos(total))
+            << std::setw(14) << total.instructions << std::setw(12) << total.dispatches
+            << std::setw(13) << total.preemptions << std::setw(12) << total.migrations;
+        all.busyNanos += total.busyNanos;
+        all.elapsedNanos += total.elapsedNanos;
+        all.instructions += total.instructions;
+        all.dispatches += total.dispatches;
+        all.preemptions += total.preemptions;
+        all.migrations += total.migrations;
+        for (size_t w = 0; w < 3; ++w) {
+            CoreSample window;
+            covered[w] = coreStats.window(core, WINDOWS[w], window);
+            allWindows[w].busyNanos += window.busyNanos;
+            allWindows[w].elapsedNanos += window.elapsedNanos;
+            out << std::setw(8) << percent(window) << "%";
         }
+        out << "\n";
+    }
+    out << std::left << std::setw(8) << "All" << std::right
+        << std::setw(12) << millis(all.busyNanos) << std::setw(12) << millis(idleNanos(all))
+        << std::setw(14) << all.instructions << std::setw(12) << all.dispatches
+        << std::setw(13) << all.preemptions << std::setw(12) << all.migrations;
+    for (size_t w = 0; w < 3; ++w) out << std::setw(8) << percent(allWindows[w]) << "%";
+    out << "\n";
+    if (covered[2] < WINDOWS[2]) {
+        out << "(windows cover at most the " << covered[2] << " s recorded so far)\n";
     }
 
+    // One value per recorded second, oldest first, rounded to whole percent.
+    out << "\nBusy % per second, oldest first:\n\n";
+    out << std::setprecision(0);
+    for (uint32_t core = 0; core < coreStats.size(); ++core) {
+        out << "Core " << core << ":";
+        for (double share : coreStats.series(core)) out << " " << share * 100.0;
+        out << "\n";
+    }
+    out.unsetf(std::ios::floatfield);
+    out << std::setprecision(6);
+    out << "\n----------------------------------------\n\n";
+}
+
+void CoreManager::printProcessMetrics(std::ostream& out) {
+    metrics.print(out);
+    out << "\n----------------------------------------\n\n";
+}
+
+void CoreManager::printLatency(std::ostream& out, int coreId) {
+    if (coreId >= int(latencyStats.size())) {
+        out << "[ERROR] No core " << coreId << "; cores are 0-" << latencyStats.size() - 1 << ".\n";
+        return;
+    }
+    latencyStats.print(out, coreId);
     out << "\n----------------------------------------\n\n";
 }
 
-int CoreManager::generateRandomInstructionCount() const {
-    std::uniform_int_distribution<uint32_t> dist(minIns, maxIns);
-    return dist(const_cast<std::default_random_engine&>(rng));
-}
\ No newline at end of file
+bool CoreManager::streamProcessMetrics(const std::string& prefix) {
+    return metrics.streamCsv(prefix + ".csv");
+}
+
+bool CoreManager::exportProcessMetrics(const std::string& prefix) {
+    bool csv = metrics.flushCsv();
+    bool json = metrics.writeJson(prefix + ".json", settings, masterSeed);
+    return csv && json;
+}
+
+// Started on first use so --simulate, which creates its own processes, never runs it.
+void CoreManager::ensureProcessPool() {
+    if (processPool.running()) return;
+    uint32_t workers = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 4));
+    processPool.start([this](int id) { return createProcess("process" + std::to_string(id), id); },
+                      processPool.nextId(), workers);
+}
+
+// Both the instruction count and the program come from the process's own seed, so a
+// process is fully determined by the master seed and its id.
+Process* CoreManager::createProcess(const std::string& name, int id) const {
+    uint64_t seed = deriveSeed(masterSeed, static_cast<uint64_t>(id));
+    Rng sizeRng(deriveSeed(seed, 0));
+    int numIns = static_cast<int>(sizeRng.between(minIns, maxIns));
+    return new Process(name, id, numIns, seed, logCapacity, programSource);
+}
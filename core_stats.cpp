@@ -0,0 +1,84 @@
+/*
+core_stats.cpp
+
+Implements the per-core counters and their per-second history. Only the history is
+locked; the counters themselves are read without a lock and may be a slice apart
+from each other.
+*/
+
+#include "core_stats.h"
+#include "clock_service.h"
+
+#include <algorithm>
+
+namespace {
+
+CoreSample difference(const CoreSample& later, const CoreSample& earlier) {
+    CoreSample out;
+    out.busyNanos = later.busyNanos - earlier.busyNanos;
+    out.elapsedNanos = later.elapsedNanos - earlier.elapsedNanos;
+    out.instructions = later.instructions - earlier.instructions;
+    out.dispatches = later.dispatches - earlier.dispatches;
+    out.preemptions = later.preemptions - earlier.preemptions;
+    out.migrations = later.migrations - earlier.migrations;
+    return out;
+}
+
+}
+
+// Busy time is credited after each step of a slice, so a sample can run a step over
+// its elapsed time; the share is capped at 1.
+double busyShare(const CoreSample& sample) {
+    if (sample.elapsedNanos == 0) return 0.0;
+    return std::min(1.0, double(sample.busyNanos) / sample.elapsedNanos);
+}
+
+void CoreStats::reset(uint32_t cores) {
+    counters.reset(new CoreCounters[cores]);
+    coreCount = cores;
+    resetAtNanos = monotonicNanos();
+    std::lock_guard<std::mutex> lock(historyMutex);
+    history.clear();
+}
+
+CoreSample CoreStats::total(uint32_t id) const {
+    const CoreCounters& c = counters[id];
+    CoreSample out;
+    out.busyNanos = c.busyNanos.load(std::memory_order_relaxed);
+    out.elapsedNanos = monotonicNanos() - resetAtNanos;
+    out.instructions = c.instructions.load(std::memory_order_relaxed);
+    out.dispatches = c.dispatches.load(std::memory_order_relaxed);
+    out.preemptions = c.preemptions.load(std::memory_order_relaxed);
+    out.migrations = c.migrations.load(std::memory_order_relaxed);
+    return out;
+}
+
+void CoreStats::recordSecond() {
+    std::vector<CoreSample> snapshot(coreCount);
+    for (uint32_t i = 0; i < coreCount; ++i) snapshot[i] = total(i);
+
+    std::lock_guard<std::mutex> lock(historyMutex);
+    history.push_back(std::move(snapshot));
+    if (history.size() > CORE_HISTORY_SECONDS + 1) history.pop_front();
+}
+
+size_t CoreStats::window(uint32_t id, size_t seconds, CoreSample& out) const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if (history.size() < 2 || id >= history.back().size()) {
+        out = CoreSample();
+        return 0;
+    }
+    size_t span = std::min(seconds, history.size() - 1);
+    out = difference(history.back()[id], history[history.size() - 1 - span][id]);
+    return span;
+}
+
+std::vector<double> CoreStats::series(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    std::vector<double> out;
+    for (size_t i = 1; i < history.size(); ++i) {
+        if (id >= history[i].size()) break;
+        out.push_back(busyShare(difference(history[i][id], history[i - 1][id])));
+    }
+    return out;
+}
@@ -0,0 +1,138 @@
+/*
+cpu_affinity.cpp
+
+Implements core thread pinning. On Linux the allowed CPU set comes from
+sched_getaffinity and NUMA nodes from /sys/devices/system/node/node<N>/cpulist; on
+Windows the first 64 logical processors of the current group are used.
+*/
+
+#include "cpu_affinity.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+const int MAX_NUMA_NODES = 1024;
+
+// Parses a sysfs CPU list such as "0-3,8-11".
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::istringstream in(text);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (...) {
+            break;
+        }
+    }
+    return cpus;
+}
+#endif
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        int count = std::max(1u, std::thread::hardware_concurrency());
+#if defined(_WIN32)
+        count = std::min(count, 64);
+#endif
+        for (int cpu = 0; cpu < count; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+}
+
+std::vector<int> hostCpuOrder() {
+    std::vector<int> allowed = allowedCpus();
+#if defined(__linux__)
+    std::vector<int> ordered;
+    for (int node = 0; node < MAX_NUMA_NODES; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file.is_open()) {
+            if (node == 0) break;       // no NUMA information at all
+            continue;                   // node ids may have gaps
+        }
+        std::string text;
+        std::getline(file, text);
+        for (int cpu : parseCpuList(text)) {
+            bool usable = std::find(allowed.begin(), allowed.end(), cpu) != allowed.end();
+            bool listed = std::find(ordered.begin(), ordered.end(), cpu) != ordered.end();
+            if (usable && !listed) ordered.push_back(cpu);
+        }
+        if (ordered.size() == allowed.size()) break;
+    }
+    for (int cpu : allowed) {
+        if (std::find(ordered.begin(), ordered.end(), cpu) == ordered.end()) ordered.push_back(cpu);
+    }
+    return ordered;
+#else
+    return allowed;
+#endif
+}
+
+std::vector<int> planCoreAffinity(const Config& config, uint32_t cores) {
+    if (config.cpuAffinity == "off" || cores == 0) return {};
+
+    std::vector<int> hostCpus = hostCpuOrder();
+    std::vector<int> source = config.cpuAffinity == "auto" ? hostCpus : config.cpuAffinityMap;
+    if (source.empty()) {
+        std::cerr << "[WARN] cpu-affinity lists no host CPUs; core threads are not pinned.\n";
+        return {};
+    }
+    for (int cpu : source) {
+        if (std::find(hostCpus.begin(), hostCpus.end(), cpu) == hostCpus.end()) {
+            std::cerr << "[WARN] cpu-affinity: host CPU " << cpu
+                      << " is not available; core threads are not pinned.\n";
+            return {};
+        }
+    }
+
+    // More simulated cores than listed CPUs wrap around the list.
+    std::vector<int> plan(cores);
+    for (uint32_t core = 0; core < cores; ++core) plan[core] = source[core % source.size()];
+    return plan;
+}
+
+bool pinCurrentThread(int hostCpu) {
+#if defined(__linux__)
+    if (hostCpu < 0 || hostCpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(hostCpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    if (hostCpu < 0 || hostCpu >= 64) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << hostCpu) != 0;
+#else
+    (void)hostCpu;
+    return false;
+#endif
+}
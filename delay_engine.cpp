@@ -0,0 +1,47 @@
+/*
+delay_engine.cpp
+
+Implements the calibrated hybrid delay: sleep until the deadline is within the spin
+window, then yield-spin until it passes. Sub-millisecond delays stay accurate while
+the host CPU is released for nearly all of a long delay.
+*/
+
+#include "delay_engine.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+static const int CALIBRATION_SAMPLES = 16;
+static const auto CALIBRATION_SLEEP = std::chrono::microseconds(200);
+static const auto MAX_SPIN_WINDOW = std::chrono::milliseconds(20);
+
+void DelayEngine::calibrate() {
+    std::vector<std::chrono::nanoseconds> overshoot;
+    overshoot.reserve(CALIBRATION_SAMPLES);
+    for (int i = 0; i < CALIBRATION_SAMPLES; ++i) {
+        auto start = Clock::now();
+        std::this_thread::sleep_for(CALIBRATION_SLEEP);
+        overshoot.push_back(Clock::now() - start - CALIBRATION_SLEEP);
+    }
+
+    // Cover the worst observed overshoot with some headroom.
+    auto worst = *std::max_element(overshoot.begin(), overshoot.end());
+    spinWindow = std::min<std::chrono::nanoseconds>(worst + worst / 4, MAX_SPIN_WINDOW);
+    calibrated = true;
+}
+
+void DelayEngine::waitFor(std::chrono::nanoseconds duration) {
+    if (duration.count() <= 0) return;
+    waitUntil(Clock::now() + duration);
+}
+
+void DelayEngine::waitUntil(Clock::time_point deadline) {
+    auto now = Clock::now();
+    if (deadline - now > spinWindow) {
+        std::this_thread::sleep_until(deadline - spinWindow);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
@@ -1,9 +1,8 @@
 #include "instruction_add.h"
 #include "instruction_utils.h"
-#include <cstdlib>
 
-Instruction generateAdd(const std::string& dest, const std::string&, const std::string&) {
-    std::string src1 = randomVarOrValue();
-    std::string src2 = randomVarOrValue();
-    return {InstructionType::ADD, {dest, src1, src2}};
+Instruction generateAdd(Rng& rng, StrId dest) {
+    StrId src1 = randomVarOrValue(rng);
+    StrId src2 = randomVarOrValue(rng);
+    return {InstructionType::ADD, 3, {dest, src1, src2}, 0, 0};
 }
@@ -1,4 +1,4 @@
 #include "instruction_declare.h"
-Instruction generateDeclare(const std::string& varName, int value) {
-    return {InstructionType::DECLARE, {varName, std::to_string(value)}};
+Instruction generateDeclare(StrId var, int value) {
+    return {InstructionType::DECLARE, 2, {var, numberString(value)}, 0, 0};
 }
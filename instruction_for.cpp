@@ -4,35 +4,49 @@
 #include "instruction_add.h"
 #include "instruction_subtract.h"
 #include "instruction_sleep.h"
-#include <cstdlib>
+#include "instruction_utils.h"
+#include <string>
 
-// Overload with depth control
-Instruction generateFor(const std::string& processName, int depth) {
-    int repeats = (rand() % 3) + 2;    
-    int blockLen = (rand() % 2) + 1;     
-    std::vector<Instruction> block;
+// Overload with depth control. Nested bodies are appended to set.nodes first, then
+// this loop's own children, so every body ends up as one contiguous range.
+Instruction generateFor(Rng& rng, InstructionSet& set, int depth) {
+    int repeats = rng.below(3) + 2;    
+    int blockLen = rng.below(2) + 1;     
+    Instruction block[2];
+    int count = 0;
 
     for (int i = 0; i < blockLen; ++i) {
-        int t = rand() % 6;  
+        int t = rng.below(6);  
 
         if (t == 0)
-            block.push_back(generatePrint(processName));
+            block[count++] = generatePrint();
         else if (t == 1)
-            block.push_back(generateDeclare("x", rand() % 10));
+            block[count++] = generateDeclare(variableId(0), rng.below(10));
         else if (t == 2)
-            block.push_back(generateAdd("x", "y", "z"));
+            block[count++] = generateAdd(rng, variableId(0));
         else if (t == 3)
-            block.push_back(generateSubtract("x", "y", "z"));
+            block[count++] = generateSubtract(rng, variableId(0));
         else if (t == 4)
-            block.push_back(generateSleep((rand() % 3) + 1));
+            block[count++] = generateSleep(rng.below(3) + 1);
         else if (t == 5 && depth < 3)
-            block.push_back(generateFor(processName, depth + 1));  
+            block[count++] = generateFor(rng, set, depth + 1);  
     }
 
-    return {InstructionType::FOR, {std::to_string(repeats)}, block};
+    uint32_t begin = static_cast<uint32_t>(set.nodes.size());
+    set.nodes.insert(set.nodes.end(), block, block + count);
+    return {InstructionType::FOR, 1, {numberString(repeats)}, begin, static_cast<uint32_t>(count)};
 }
 
 // Entry point
-Instruction generateFor(const std::string& processName) {
-    return generateFor(processName, 1);  // start at depth 1
+Instruction generateFor(Rng& rng, InstructionSet& set) {
+    return generateFor(rng, set, 1);  // start at depth 1
+}
+
+int dynamicInstructionCount(const InstructionSet& set, const Instruction& ins) {
+    if (ins.type != InstructionType::FOR) return 1;
+    int body = 0;
+    for (uint32_t i = 0; i < ins.blockLen; ++i) body += dynamicInstructionCount(set, set.nodes[ins.blockBegin + i]);
+    uint16_t repeats = 0;
+    internedNumber(ins.args[0], repeats);
+    return repeats * body;
 }
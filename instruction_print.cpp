@@ -1,5 +1,6 @@
 #include "instruction_print.h"
 
-Instruction generatePrint(const std::string& processName) {
-    return {InstructionType::PRINT, {"Hello world from " + processName + "!"}};
+Instruction generatePrint() {
+    static const StrId message = internString("Hello world from {name}!");
+    return {InstructionType::PRINT, 1, {message}, 0, 0};
 }
@@ -5,32 +5,52 @@
 #include "instruction_print.h"
 #include "instruction_sleep.h"
 #include "instruction_for.h"
-#include <cstdlib>
+#include "instruction_utils.h"
 
-std::vector<Instruction> generateInstructionSet(const std::string& processName, int totalInstructions) {
-    std::vector<Instruction> instructions;
+// Units are budgeted so the whole program executes exactly totalInstructions counted
+// instructions, counting every unrolled FOR body instruction and never the FOR itself.
+bool generateNextUnit(GeneratorState& state, InstructionSet& out) {
+    Rng& rng = state.rng;
+    if (state.remaining <= 0) return false;
 
-    for (const auto& var : {"x", "y", "z"}) {
-        instructions.push_back(generateDeclare(var, rand() % 20));
+    if (state.declared < 3) {
+        out.top.push_back(generateDeclare(variableId(state.declared++), rng.below(20)));
+        --state.remaining;
+        return true;
     }
 
-    for (int i = 3; i < totalInstructions; ++i) {
-        int r = rand() % 6;
+    while (true) {
+        int r = rng.below(6);
 
         if (r == 5) {
-            instructions.push_back(generateFor(processName));
+            size_t mark = out.nodes.size();
+            Instruction loop = generateFor(rng, out);
+            int cost = dynamicInstructionCount(out, loop);
+            if (cost == 0 || cost > state.remaining) {
+                out.nodes.resize(mark);     // drop the rejected loop's body
+                continue;
+            }
+            out.top.push_back(loop);
+            state.remaining -= cost;
+            return true;
         } else if (r == 0) {
-            instructions.push_back(generatePrint(processName));
+            out.top.push_back(generatePrint());
         } else if (r == 1) {
-            instructions.push_back(generateDeclare("x", rand() % 10));
+            out.top.push_back(generateDeclare(variableId(0), rng.below(10)));
         } else if (r == 2) {
-            instructions.push_back(generateAdd("x", "y", "z"));
+            out.top.push_back(generateAdd(rng, variableId(0)));
         } else if (r == 3) {
-            instructions.push_back(generateSubtract("x", "y", "z"));
+            out.top.push_back(generateSubtract(rng, variableId(0)));
         } else if (r == 4) {
-            instructions.push_back(generateSleep(rand() % 3 + 1));
+            out.top.push_back(generateSleep(rng.below(3) + 1));
         }
+        --state.remaining;
+        return true;
     }
+}
 
-    return instructions;
+void generateInstructionSet(InstructionSet& out, int totalInstructions, uint64_t seed) {
+    out.clear();
+    GeneratorState state(seed, totalInstructions);
+    while (generateNextUnit(state, out)) {}
 }
@@ -1,4 +1,4 @@
 #include "instruction_sleep.h"
 Instruction generateSleep(int ticks) {
-    return {InstructionType::SLEEP, {std::to_string(ticks)}};
-}
\ No newline at end of file
+    return {InstructionType::SLEEP, 1, {numberString(ticks)}, 0, 0};
+}
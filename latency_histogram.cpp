@@ -0,0 +1,183 @@
+/*
+latency_histogram.cpp
+
+Implements the log-linear latency histograms, their merged report, and the
+thread-local hooks the ready queues and core parking record through.
+*/
+
+#include "latency_histogram.h"
+#include "clock_service.h"
+#include "core_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace {
+
+thread_local CoreLatency* currentLatency = nullptr;
+
+uint32_t highestBit(uint64_t value) {
+#if defined(__GNUC__)
+    return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#else
+    uint32_t bit = 0;
+    while (value >>= 1) ++bit;
+    return bit;
+#endif
+}
+
+std::string formatNanos(uint64_t nanos) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (nanos < 1000) out << nanos << " ns";
+    else if (nanos < 1000000) out << nanos / 1e3 << " us";
+    else if (nanos < 1000000000) out << nanos / 1e6 << " ms";
+    else out << nanos / 1e9 << " s";
+    return out.str();
+}
+
+}
+
+const char* latencyKindName(LatencyKind kind) {
+    switch (kind) {
+    case LatencyKind::DISPATCH: return "enqueue->dispatch";
+    case LatencyKind::LOCK_WAIT: return "queue lock wait";
+    case LatencyKind::WAKEUP: return "wake-up";
+    case LatencyKind::SLICE: return "slice length";
+    default: return "?";
+    }
+}
+
+uint32_t LatencyHistogram::bucketOf(uint64_t nanos) {
+    const uint64_t linear = uint64_t(1) << LATENCY_SUB_BITS;
+    if (nanos < linear) return static_cast<uint32_t>(nanos);
+    uint32_t shift = highestBit(nanos) - LATENCY_SUB_BITS;
+    uint32_t sub = static_cast<uint32_t>(nanos >> shift) & (linear - 1);
+    uint32_t bucket = ((shift + 1) << LATENCY_SUB_BITS) + sub;
+    return std::min(bucket, LATENCY_BUCKETS - 1);
+}
+
+uint64_t LatencyHistogram::bucketUpper(uint32_t bucket) {
+    const uint64_t linear = uint64_t(1) << LATENCY_SUB_BITS;
+    if (bucket < linear) return bucket;
+    uint32_t shift = (bucket >> LATENCY_SUB_BITS) - 1;
+    uint64_t sub = bucket & (linear - 1);
+    return ((linear + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    bumpCounter(buckets[bucketOf(nanos)]);
+    bumpCounter(total);
+    bumpCounter(sum, nanos);
+    if (nanos > largest.load(std::memory_order_relaxed)) largest.store(nanos, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        bumpCounter(buckets[i], other.buckets[i].load(std::memory_order_relaxed));
+    }
+    bumpCounter(total, other.total.load(std::memory_order_relaxed));
+    bumpCounter(sum, other.sum.load(std::memory_order_relaxed));
+    largest.store(std::max(max(), other.max()), std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n > 0 ? double(sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * n)));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) return std::min(bucketUpper(i), max());
+    }
+    return max();
+}
+
+void LatencyStats::reset(uint32_t cores) {
+    latency.reset(new CoreLatency[cores]);
+    coreCount = cores;
+}
+
+void LatencyStats::print(std::ostream& out, int coreId) const {
+    const size_t kinds = size_t(LatencyKind::COUNT);
+    // Merged into a heap copy: a full set of histograms is several kilobytes.
+    std::unique_ptr<CoreLatency> merged(new CoreLatency());
+    uint32_t first = coreId < 0 ? 0 : uint32_t(coreId);
+    uint32_t last = coreId < 0 ? coreCount : std::min(coreCount, uint32_t(coreId) + 1);
+    for (uint32_t core = first; core < last; ++core) {
+        const CoreLatency& source = latency[core];
+        for (size_t k = 0; k < kinds; ++k) merged->kinds[k].merge(source.kinds[k]);
+        bumpCounter(merged->parks, source.parks.load(std::memory_order_relaxed));
+        bumpCounter(merged->parkTimeouts, source.parkTimeouts.load(std::memory_order_relaxed));
+        bumpCounter(merged->emptyWakeups, source.emptyWakeups.load(std::memory_order_relaxed));
+    }
+
+    if (coreId < 0) out << "Scheduler latency (all " << coreCount << " cores):\n\n";
+    else out << "Scheduler latency (core " << coreId << "):\n\n";
+    out << std::left << std::setw(20) << "Interval" << std::right << std::setw(12) << "Count"
+        << std::setw(11) << "Mean" << std::setw(11) << "p50" << std::setw(11) << "p90"
+        << std::setw(11) << "p99" << std::setw(11) << "p99.9" << std::setw(11) << "Max" << "\n";
+    for (size_t k = 0; k < kinds; ++k) {
+        const LatencyHistogram& h = merged->kinds[k];
+        out << std::left << std::setw(20) << latencyKindName(LatencyKind(k)) << std::right
+            << std::setw(12) << h.count()
+            << std::setw(11) << formatNanos(uint64_t(h.mean()))
+            << std::setw(11) << formatNanos(h.percentile(0.50))
+            << std::setw(11) << formatNanos(h.percentile(0.90))
+            << std::setw(11) << formatNanos(h.percentile(0.99))
+            << std::setw(11) << formatNanos(h.percentile(0.999))
+            << std::setw(11) << formatNanos(h.max()) << "\n";
+    }
+    out << "\nParks: " << merged->parks.load() << "  Timed out: " << merged->parkTimeouts.load()
+        << "  Woken to an empty queue: " << merged->emptyWakeups.load() << "\n";
+}
+
+void setThreadLatency(CoreLatency* latency) {
+    currentLatency = latency;
+}
+
+CoreLatency* threadLatency() {
+    return currentLatency;
+}
+
+void recordLockWait(uint64_t nanos) {
+    if (currentLatency) (*currentLatency)[LatencyKind::LOCK_WAIT].record(nanos);
+}
+
+void recordPark(bool notified, uint64_t wakeNanos) {
+    CoreLatency* latency = currentLatency;
+    if (!latency) return;
+    bumpCounter(latency->parks);
+    if (notified) (*latency)[LatencyKind::WAKEUP].record(wakeNanos);
+    else bumpCounter(latency->parkTimeouts);
+}
+
+void recordEmptyWakeup() {
+    if (currentLatency) bumpCounter(currentLatency->emptyWakeups);
+}
+
+// Uncontended acquisitions are recorded as zero so the histogram also shows how often
+// cores had to wait at all.
+std::unique_lock<std::mutex> timedLock(std::mutex& mutex) {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        recordLockWait(0);
+        return lock;
+    }
+    if (!currentLatency) {
+        lock.lock();
+        return lock;
+    }
+    uint64_t start = monotonicNanos();
+    lock.lock();
+    recordLockWait(monotonicNanos() - start);
+    return lock;
+}
@@ -0,0 +1,44 @@
+/*
+log_archive.cpp
+
+Implements the append-only log archive. Entries are formatted on the core that
+finished the process and written through one buffered stream under a mutex.
+*/
+
+#include "log_archive.h"
+#include "process.h"
+#include "util.h"
+
+#include <iostream>
+#include <sstream>
+
+bool LogArchive::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.is_open()) file.close();
+    file.open(path, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Failed to open log archive: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+void LogArchive::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.is_open()) file.close();
+}
+
+void LogArchive::append(const Process& proc) {
+    std::ostringstream entry;
+    entry << proc.name << " (id " << proc.id << ")  Core: " << proc.assignedCore
+          << "  Created: " << proc.timestamp
+          << "  Finished: " << formatTimestamp(proc.finishedAt)
+          << "  " << proc.executedInstructions << " / " << proc.totalInstructions << "\n";
+    for (const auto& line : proc.readLogs()) {
+        entry << "  (" << formatTimestamp(line.time) << ") Core:" << line.core
+              << " \"" << line.message << "\"\n";
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.is_open()) file << entry.str();
+}
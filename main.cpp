@@ -10,6 +10,7 @@ menu logic, command parsing, and overall program flow.
 #include "screen.h"
 #include "process.h"
 #include "core_manager.h"
+#include "clock_service.h"
 
 #include <iostream>
 #include <string>
@@ -20,11 +21,59 @@ CoreManager coreManager;
 bool schedulerStarted = false;
 bool isInitialized = false;
 
-int main() {
+// Optional "<N>" after a report command: how many recently finished processes to list.
+static size_t parseFinishedLimit(const std::string& command, size_t argStart) {
+    if (command.size() <= argStart) return DEFAULT_FINISHED_LIMIT;
+    try {
+        return std::stoul(command.substr(argStart));
+    } catch (...) {
+        return DEFAULT_FINISHED_LIMIT;
+    }
+}
+
+// Per-process rows stream to <prefix>.csv from initialize on; report-util flushes them
+// and writes the aggregates to <prefix>.json.
+static const char* METRICS_PREFIX = "csopesy-metrics";
+
+// emulator --simulate [--processes N] [--seed S] [--metrics PREFIX]
+static int runSimulationMode(int argc, char* argv[]) {
+    uint64_t processCount = 10000;
+    uint64_t seed = 0;
+    std::string metricsPrefix;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--processes") processCount = std::stoull(argv[i + 1]);
+        else if (flag == "--seed") seed = std::stoull(argv[i + 1]);
+        else if (flag == "--metrics") metricsPrefix = argv[i + 1];
+        else {
+            std::cerr << "[ERROR] Unknown option: " << flag << "\n";
+            return 1;
+        }
+    }
+
+    Config config;
+    if (!loadConfig("config.txt", config)) return 1;
+    // --seed overrides the config; runs are reproducible even when neither sets one.
+    if (seed != 0) config.seed = seed;
+    else if (config.seed == 0) config.seed = 1;
+    coreManager.configure(config);
+    if (!metricsPrefix.empty() && !coreManager.streamProcessMetrics(metricsPrefix)) return 1;
+    coreManager.runSimulation(processCount, std::cout);
+    if (!metricsPrefix.empty() && !coreManager.exportProcessMetrics(metricsPrefix)) return 1;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--simulate") {
+        return runSimulationMode(argc, argv);
+    }
+
     std::string command;
     Config config;
     bool isRunning = true;
 
+    startClockService();
+
     clearScreen();
     printHeader();
 
@@ -45,16 +94,9 @@ int main() {
         }
         else if (command == "initialize") {
             if (loadConfig("config.txt", config)) {
-                coreManager.configure(
-                    config.numCPU,
-                    config.schedulerType,
-                    config.quantumCycles,
-                    config.batchProcFreq,
-                    config.minIns,
-                    config.maxIns,
-                    config.delayPerExec
-                );
-                std::cout << "\n[OK] Configuration loaded.\n\n";
+                coreManager.configure(config);
+                coreManager.streamProcessMetrics(METRICS_PREFIX);
+                std::cout << "\n[OK] Configuration loaded (workload seed " << coreManager.workloadSeed() << ").\n\n";
                 std::this_thread::sleep_for(std::chrono::seconds(2));
                 clearScreen();
                 printHeader();
@@ -103,38 +145,66 @@ int main() {
                 printHeader();
             }
         }
-        else if (command == "report-util") {
+        else if (command == "report-util" || command.rfind("report-util ", 0) == 0) {
             std::ofstream file("csopesy-log.txt");
-            coreManager.printProcessSummary(file, false);
+            coreManager.printProcessSummary(file, false, parseFinishedLimit(command, 12));
+            coreManager.printCoreUtilization(file);
+            coreManager.printProcessMetrics(file);
+            coreManager.printLatency(file);
             file.close();
+            coreManager.exportProcessMetrics(METRICS_PREFIX);
             std::cout << "\n[INFO] Report generated at csopesy-log.txt!\n";
+            std::cout << "[INFO] Process metrics saved to " << METRICS_PREFIX << ".csv and .json\n";
             std::this_thread::sleep_for(std::chrono::seconds(2));
             clearScreen();
             printHeader();
         }
-        else if (command == "screen -ls") {
-            coreManager.printProcessSummary(std::cout, true);
+        else if (command == "latency" || command.rfind("latency ", 0) == 0) {
+            if (!isInitialized) {
+                std::cout << "\n[WARN] Please run 'initialize' first.\n\n";
+                continue;
+            }
+            int coreId = -1;
+            if (command.size() > 8) {
+                try {
+                    coreId = std::stoi(command.substr(8));
+                } catch (...) {
+                    std::cout << "\n[ERROR] Usage: latency [core]\n\n";
+                    continue;
+                }
+            }
+            std::cout << "\n";
+            coreManager.printLatency(std::cout, coreId);
+        }
+        else if (command == "screen -ls" || command.rfind("screen -ls ", 0) == 0) {
+            coreManager.printProcessSummary(std::cout, true, parseFinishedLimit(command, 11));
         }
         else if (command.rfind("screen -s ", 0) == 0 && schedulerStarted) {
             std::string pname = command.substr(10);
-            Process* existing = coreManager.getProcessByName(pname);
-
-            if (existing != nullptr) {
+            if (coreManager.hasProcess(pname)) {
                 std::cout << "\n[ERROR] Process '" << pname << "' already exists. Use 'screen -r " << pname << "' to reattach.\n";
                 std::this_thread::sleep_for(std::chrono::seconds(2));
                 clearScreen();
                 printHeader();
             } else {
                 Process* newProc = coreManager.spawnNewNamedProcess(pname);
-                enterProcessScreen(newProc);
+                if (newProc) {
+                    enterProcessScreen(newProc);
+                    coreManager.detachProcess(newProc);
+                } else {
+                    std::this_thread::sleep_for(std::chrono::seconds(2));
+                    clearScreen();
+                    printHeader();
+                }
             }
         }
         else if (command.rfind("screen -r ", 0) == 0 && schedulerStarted) {
             std::string pname = command.substr(10);
-            Process* proc = coreManager.getProcessByName(pname);
-            if (proc && !proc->isFinished()) {
-                enterProcessScreen(proc);
-            } else {
+            Process* proc = coreManager.attachProcess(pname);
+            bool active = proc && !proc->isFinished();
+            if (active) enterProcessScreen(proc);
+            if (proc) coreManager.detachProcess(proc);
+            if (!active) {
                 std::cout << "\nProcess " << pname << " not found or has finished.\n";
                 std::this_thread::sleep_for(std::chrono::seconds(2));
                 clearScreen();
@@ -149,5 +219,6 @@ int main() {
         }
     }
 
+    stopClockService();
     return 0;
 }
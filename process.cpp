@@ -1,5 +1,6 @@
 #include "process.h"
 #include "util.h"
+#include "clock_service.h"
 #include "instruction_random.h"
 
 #include <iomanip>
@@ -7,108 +8,155 @@
 #include <iostream>     
 #include <thread>  
 #include <chrono>     
-#include <sstream>
 #include <vector>
 
-Process::Process(const std::string& name, int id, int totalIns)
-    : name(name), id(id), totalInstructions(totalIns), executedInstructions(0), assignedCore(-1) {
-    
-    // Set timestamp
-    std::time_t now = std::time(nullptr);
-    char buf[100];
-    std::strftime(buf, sizeof(buf), "%m/%d/%Y %I:%M:%S %p", std::localtime(&now));
-    timestamp = buf;
+Process::Process(const std::string& name, int id, int totalIns, uint64_t seed, size_t logCapacity,
+                 ProgramSource source)
+    : name(name), id(id), totalInstructions(totalIns), executedInstructions(0), assignedCore(-1),
+      logs(logCapacity), source(source) {
+    timestamp = getCurrentTimestamp();
 
-    instructions = generateInstructionSet(name, totalIns);
+    if (source == ProgramSource::STREAM) {
+        generator = GeneratorState(seed, totalIns);
+        return;
+    }
+
+    // The generator output is scratch space: reuse one buffer per thread so creating
+    // a process allocates only its compiled op vector.
+    static thread_local InstructionSet scratch;
+    generateInstructionSet(scratch, totalIns, seed);
+    program = compileProgram(scratch);
 }
 
 bool Process::isFinished() const {
     return executedInstructions >= totalInstructions;
 }
 
-void Process::logPrint(const std::string& message) {
-    std::ostringstream oss;
-    oss << "(" << getCurrentTimestamp() << ") "
-        << "Core:" << assignedCore << " \"" << message << "\"";
-    logs.push_back(oss.str());
+void Process::logPrint(StrId message) {
+    logs.append(LogRecord{cachedEpochSeconds(), assignedCore, message});
+}
+
+// Interned messages are shared templates; the process name is filled in here.
+std::vector<LogLine> Process::readLogs() const {
+    static const std::string NAME_FIELD = "{name}";
+    std::vector<LogLine> lines;
+    logs.forEach([&](const LogRecord& record) {
+        std::string message = internedString(record.message);
+        size_t at = message.find(NAME_FIELD);
+        if (at != std::string::npos) message.replace(at, NAME_FIELD.size(), name);
+        lines.push_back(LogLine{record.time, record.core, std::move(message)});
+    });
+    return lines;
 }
 
-void Process::executeSingleInstruction(const Instruction& ins) {
-    switch (ins.type) {
-        case InstructionType::PRINT:
-            logPrint(ins.args[0]);
+void Process::compact() {
+    generator = GeneratorState();
+    program = Program();
+}
+
+void Process::executeSingleInstruction(const Op& op) {
+    switch (op.code) {
+        case Opcode::PRINT:
+            logPrint(opString(op));
             break;
-        case InstructionType::DECLARE:
-            variables[ins.args[0]] = static_cast<uint16_t>(std::stoi(ins.args[1]));
+        case Opcode::DECLARE:
+            registers[op.dst] = op.a;
             break;
-        case InstructionType::ADD: {
-            uint16_t v2 = 0, v3 = 0;
-            if (variables.count(ins.args[1])) v2 = variables[ins.args[1]];
-            else try { v2 = static_cast<uint16_t>(std::stoi(ins.args[1])); } catch (...) {}
-            if (variables.count(ins.args[2])) v3 = variables[ins.args[2]];
-            else try { v3 = static_cast<uint16_t>(std::stoi(ins.args[2])); } catch (...) {}
-            uint32_t sum = v2 + v3;
+        case Opcode::ADD: {
+            uint32_t sum = uint32_t(readOperand(op.a, op.flags & OPERAND_A_SLOT)) + readOperand(op.b, op.flags & OPERAND_B_SLOT);
             if (sum > 65535) sum = 65535;
-            variables[ins.args[0]] = static_cast<uint16_t>(sum);
+            registers[op.dst] = static_cast<uint16_t>(sum);
             break;
         }
-        case InstructionType::SUBTRACT: {
-            uint16_t v2 = 0, v3 = 0;
-            if (variables.count(ins.args[1])) v2 = variables[ins.args[1]];
-            else try { v2 = static_cast<uint16_t>(std::stoi(ins.args[1])); } catch (...) {}
-            if (variables.count(ins.args[2])) v3 = variables[ins.args[2]];
-            else try { v3 = static_cast<uint16_t>(std::stoi(ins.args[2])); } catch (...) {}
-            int diff = v2 - v3;
+        case Opcode::SUBTRACT: {
+            int diff = int(readOperand(op.a, op.flags & OPERAND_A_SLOT)) - readOperand(op.b, op.flags & OPERAND_B_SLOT);
             if (diff < 0) diff = 0;
-            variables[ins.args[0]] = static_cast<uint16_t>(diff);
+            registers[op.dst] = static_cast<uint16_t>(diff);
             break;
         }
-        case InstructionType::SLEEP:
-            sleepTicks = std::stoi(ins.args[0]);
+        case Opcode::SLEEP:
+            sleepTicks = op.a;
             break;
         default: break;
     }
 }
 
-bool Process::executeNextInstruction() {
-    if (sleepTicks > 0) {
-        --sleepTicks;
-        return true;
-    }
+// Executes the next counted instruction, running loop-control ops inline on the way.
+// Returns false when the program has no instructions left.
+bool Process::stepInstruction() {
+    do {
+        const Op* code = program.code.data();
+        size_t size = program.code.size();
+        while (instructionPointer < size) {
+            const Op& op = code[instructionPointer];
+            switch (op.code) {
+                case Opcode::LOOP_BEGIN:
+                    loopCounters[loopDepth++] = op.a;
+                    ++instructionPointer;
+                    break;
+                case Opcode::LOOP_END:
+                    if (--loopCounters[loopDepth - 1] > 0) {
+                        instructionPointer = opTarget(op);
+                    } else {
+                        --loopDepth;
+                        ++instructionPointer;
+                    }
+                    break;
+                default:
+                    executeSingleInstruction(op);
+                    ++instructionPointer;
+                    return true;
+            }
+        }
+    } while (refillProgram());
+    return false;
+}
 
-    if (!forStack.empty()) {
-        auto& tup = forStack.back();
-        size_t& instrIdx = std::get<0>(tup);
-        size_t& blockPtr = std::get<1>(tup);
-        int& left = std::get<2>(tup);
-        Instruction& forIns = instructions[instrIdx];
-        if (blockPtr < forIns.block.size()) {
-            Instruction& curr = forIns.block[blockPtr];
-            executeSingleInstruction(curr);
-            ++blockPtr;
-            ++executedInstructions;
-        } else if (left > 1) {
-            blockPtr = 0;
-            --left;
-        } else {
-            forStack.pop_back();
-            ++instructionPointer;
-            ++executedInstructions;
+// Replaces a streamed program's exhausted window with the next run of generated ops.
+// Windows always end on a unit boundary, so no loop is open across a refill.
+bool Process::refillProgram() {
+    if (source != ProgramSource::STREAM || generator.remaining <= 0) return false;
+
+    static thread_local InstructionSet scratch;
+    scratch.clear();
+    while (scratch.top.size() < STREAM_WINDOW_UNITS && generateNextUnit(generator, scratch)) {}
+
+    program.code.clear();
+    appendProgram(program, scratch);
+    instructionPointer = 0;
+    return true;
+}
+
+SliceResult Process::runSlice(uint32_t maxSteps) {
+    SliceResult result = {0, 0, SliceStop::QUANTUM_EXPIRED};
+    int remaining = totalInstructions - executedInstructions.load(std::memory_order_relaxed);
+
+    while (result.steps < maxSteps) {
+        if (sleepTicks > 0) {
+            --sleepTicks;
+            ++result.steps;
+            continue;
+        }
+        if (remaining <= 0 || !stepInstruction()) {
+            result.reason = SliceStop::FINISHED;
+            break;
+        }
+        ++result.steps;
+        ++result.executed;
+        if (--remaining <= 0) {
+            result.reason = SliceStop::FINISHED;
+            break;
+        }
+        if (sleepTicks > 0) {
+            result.reason = SliceStop::SLEEP;
+            break;
         }
-        return true;
     }
 
-    if (instructionPointer >= instructions.size()) return false;
-    Instruction& ins = instructions[instructionPointer];
-
-    if (ins.type == InstructionType::FOR) {
-        int repeats = std::stoi(ins.args[0]);
-        forStack.push_back(std::make_tuple(instructionPointer, 0, repeats));
-        return true;
-    } else {
-        executeSingleInstruction(ins);
-        ++instructionPointer;
-        ++executedInstructions;
-        return true;
-    }
+    if (result.executed > 0) executedInstructions.fetch_add(result.executed, std::memory_order_release);
+    return result;
+}
+
+bool Process::executeNextInstruction() {
+    return runSlice(1).steps > 0;
 }
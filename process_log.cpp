@@ -0,0 +1,25 @@
+/*
+process_log.cpp
+
+Implements the bounded per-process log ring. Storage is only allocated once a
+process actually prints, and the oldest records are overwritten at capacity.
+*/
+
+#include "process_log.h"
+
+void LogRing::append(const LogRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++total;
+    if (capacity == 0) return;
+    if (records.size() < capacity) {
+        records.push_back(record);
+        return;
+    }
+    records[head] = record;
+    head = (head + 1) % capacity;
+}
+
+uint64_t LogRing::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return total - records.size();
+}
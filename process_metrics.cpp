@@ -0,0 +1,169 @@
+/*
+process_metrics.cpp
+
+Implements the finished-process metrics log. Recording folds one process into the
+histograms and, when a CSV is streamed, formats its row into the file's buffer, both
+under one mutex; a report reads a few thousand buckets, however many processes have
+finished.
+*/
+
+#include "process_metrics.h"
+#include "config.h"
+#include "process.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const char* METRIC_NAMES[] = {"response", "turnaround", "wait", "run", "preemptions"};
+const size_t METRIC_COUNT = size_t(Metric::COUNT);
+
+uint64_t metricValue(const ProcessMetrics& m, Metric metric) {
+    switch (metric) {
+    case Metric::RESPONSE: return m.response;
+    case Metric::TURNAROUND: return m.turnaround;
+    case Metric::WAIT: return m.wait;
+    case Metric::RUN: return m.run;
+    default: return m.preemptions;
+    }
+}
+
+// Names come from screen -s and may hold anything; quote the ones CSV would split.
+std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) return text;
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+}
+
+MetricsLog::MetricsLog() : histograms(new LatencyHistogram[METRIC_COUNT]) {}
+
+void MetricsLog::clear(MetricUnit unit, uint64_t origin) {
+    std::lock_guard<std::mutex> lock(mutex);
+    histograms.reset(new LatencyHistogram[METRIC_COUNT]);
+    count = 0;
+    timeUnit = unit;
+    arrivalOrigin = origin;
+    if (csv.is_open()) openCsv();
+}
+
+MetricUnit MetricsLog::unit() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return timeUnit;
+}
+
+void MetricsLog::record(const Process& proc) {
+    const ProcessTimes& t = proc.times;
+    ProcessMetrics m;
+    m.response = t.firstDispatchAt == NOT_DISPATCHED ? 0 : t.firstDispatchAt - t.arrivedAt;
+    m.turnaround = t.finishedAt - t.arrivedAt;
+    m.wait = t.waitTime;
+    m.run = t.runTime;
+    m.preemptions = t.preemptions;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    m.arrival = t.arrivedAt - arrivalOrigin;
+    for (size_t metric = 0; metric < METRIC_COUNT; ++metric) {
+        histograms[metric].record(metricValue(m, Metric(metric)));
+    }
+    ++count;
+    if (csv.is_open()) {
+        csv << csvField(proc.name) << ',' << proc.id << ',' << m.arrival << ',' << m.response << ','
+            << m.turnaround << ',' << m.wait << ',' << m.run << ',' << m.preemptions << '\n';
+    }
+}
+
+uint64_t MetricsLog::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
+
+bool MetricsLog::streamCsv(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    csvPath = path;
+    return openCsv();
+}
+
+// Caller holds mutex.
+bool MetricsLog::openCsv() {
+    if (csv.is_open()) csv.close();
+    csv.clear();
+    csv.open(csvPath, std::ios::out | std::ios::trunc);
+    if (!csv.is_open()) {
+        std::cerr << "[ERROR] Failed to write metrics: " << csvPath << "\n";
+        return false;
+    }
+    csv << "name,id,arrival,response,turnaround,wait,run,preemptions\n";
+    return true;
+}
+
+bool MetricsLog::flushCsv() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!csv.is_open()) return false;
+    csv.flush();
+    if (!csv) {
+        std::cerr << "[ERROR] Failed to write metrics: " << csvPath << "\n";
+        return false;
+    }
+    return true;
+}
+
+MetricSummary MetricsLog::summary(Metric metric) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const LatencyHistogram& h = histograms[size_t(metric)];
+    MetricSummary s;
+    s.mean = h.mean();
+    s.p50 = h.percentile(0.50);
+    s.p95 = h.percentile(0.95);
+    s.p99 = h.percentile(0.99);
+    return s;
+}
+
+void MetricsLog::print(std::ostream& out) const {
+    bool nanos = unit() == MetricUnit::NANOS;
+    out << "Process metrics (" << (nanos ? "microseconds" : "CPU ticks") << ", " << size()
+        << " finished; percentiles within 1/8):\n\n";
+    out << std::left << std::setw(14) << "Metric" << std::right << std::setw(14) << "Mean"
+        << std::setw(12) << "p50" << std::setw(12) << "p95" << std::setw(12) << "p99" << "\n";
+    out << std::fixed << std::setprecision(1);
+    for (size_t metric = 0; metric < METRIC_COUNT; ++metric) {
+        const MetricSummary s = summary(Metric(metric));
+        double scale = nanos && Metric(metric) != Metric::PREEMPTIONS ? 1e-3 : 1.0;
+        out << std::left << std::setw(14) << METRIC_NAMES[metric] << std::right
+            << std::setw(14) << s.mean * scale << std::setw(12) << s.p50 * scale
+            << std::setw(12) << s.p95 * scale << std::setw(12) << s.p99 * scale << "\n";
+    }
+    out.unsetf(std::ios::floatfield);
+}
+
+bool MetricsLog::writeJson(const std::string& path, const Config& config, uint64_t seed) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[ERROR] Failed to write metrics: " << path << "\n";
+        return false;
+    }
+    file << std::fixed << std::setprecision(3);
+    file << "{\n";
+    file << "  \"scheduler\": \"" << config.schedulerType << "\",\n";
+    file << "  \"cores\": " << config.numCPU << ",\n";
+    file << "  \"quantumCycles\": " << config.quantumCycles << ",\n";
+    file << "  \"seed\": " << seed << ",\n";
+    file << "  \"unit\": \"" << (unit() == MetricUnit::NANOS ? "ns" : "ticks") << "\",\n";
+    file << "  \"processes\": " << size() << ",\n";
+    for (size_t metric = 0; metric < METRIC_COUNT; ++metric) {
+        const MetricSummary s = summary(Metric(metric));
+        file << "  \"" << METRIC_NAMES[metric] << "\": {\"mean\": " << s.mean << ", \"p50\": " << s.p50
+             << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << "}"
+             << (metric + 1 < METRIC_COUNT ? "," : "") << "\n";
+    }
+    file << "}\n";
+    return true;
+}
@@ -0,0 +1,112 @@
+/*
+process_pool.cpp
+
+Implements the prefetching process pool. Only id bookkeeping happens under the lock;
+programs are generated outside it, so workers build in parallel.
+*/
+
+#include "process_pool.h"
+#include "process.h"
+
+#include <stdexcept>
+
+ProcessPool::~ProcessPool() {
+    stop();
+}
+
+void ProcessPool::start(Factory f, int firstId, uint32_t count) {
+    stop();
+    factory = std::move(f);
+    slots.assign(PROCESS_POOL_CAPACITY, nullptr);
+    claimed = next = firstId;
+    stopping = false;
+    failure.clear();
+    for (uint32_t i = 0; i < count; ++i) workers.emplace_back(&ProcessPool::workerLoop, this);
+}
+
+void ProcessPool::stop() {
+    if (workers.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taken.notify_all();
+    built.notify_all();
+    for (auto& t : workers) t.join();
+    workers.clear();
+
+    for (auto& proc : slots) {
+        delete proc;
+        proc = nullptr;
+    }
+    // Ids built ahead but never handed out are reused by the next start().
+    claimed = next;
+}
+
+void ProcessPool::workerLoop() {
+    while (true) {
+        int64_t id;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taken.wait(lock, [this] {
+                return stopping || claimed < next + static_cast<int64_t>(slots.size());
+            });
+            if (stopping) return;
+            id = claimed++;
+        }
+
+        Process* proc = nullptr;
+        try {
+            proc = factory(static_cast<int>(id));
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(mutex);
+            failure = e.what();
+            stopping = true;
+            built.notify_all();
+            taken.notify_all();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots[id % slots.size()] = proc;
+        }
+        built.notify_all();
+    }
+}
+
+Process* ProcessPool::take() {
+    Process* proc = nullptr;
+    takeBatch(&proc, 1);
+    return proc;
+}
+
+size_t ProcessPool::takeBatch(Process** out, size_t max) {
+    size_t count = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        built.wait(lock, [this] { return slots[next % slots.size()] != nullptr || stopping; });
+        if (!slots[next % slots.size()]) {
+            throw std::runtime_error(failure.empty() ? "Process pool stopped" : failure);
+        }
+        while (count < max) {
+            Process*& slot = slots[next % slots.size()];
+            if (!slot) break;
+            out[count++] = slot;
+            slot = nullptr;
+            ++next;
+        }
+    }
+    taken.notify_all();
+    return count;
+}
+
+bool ProcessPool::running() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !workers.empty() && !stopping;
+}
+
+int ProcessPool::nextId() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(next);
+}
@@ -0,0 +1,142 @@
+/*
+process_registry.cpp
+
+Implements the live-process registry and the bounded finished-process history.
+*/
+
+#include "process_registry.h"
+#include "process.h"
+
+#include <algorithm>
+#include <functional>
+
+FinishedHistory::FinishedHistory() : ring(FINISHED_HISTORY_CAPACITY) {}
+
+void FinishedHistory::append(const Process& proc) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t n = count.load(std::memory_order_relaxed);
+    ProcessSummary& slot = ring[n % ring.size()];
+    slot.name = proc.name;
+    slot.id = proc.id;
+    slot.core = proc.assignedCore;
+    slot.timestamp = proc.timestamp;
+    slot.finishedAt = proc.finishedAt;
+    slot.totalInstructions = proc.totalInstructions;
+    count.store(n + 1, std::memory_order_release);
+}
+
+std::vector<ProcessSummary> FinishedHistory::latest(size_t n) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t total = count.load(std::memory_order_relaxed);
+    uint64_t held = std::min<uint64_t>(total, ring.size());
+    uint64_t shown = std::min<uint64_t>(held, n);
+    std::vector<ProcessSummary> out;
+    out.reserve(shown);
+    for (uint64_t i = total - shown; i < total; ++i) out.push_back(ring[i % ring.size()]);
+    return out;
+}
+
+void FinishedHistory::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    count.store(0, std::memory_order_release);
+}
+
+ProcessRegistry::NameShard& ProcessRegistry::nameShard(const std::string& name) const {
+    return nameShards[std::hash<std::string>()(name) % SHARD_COUNT];
+}
+
+ProcessRegistry::IdShard& ProcessRegistry::idShard(int id) const {
+    return idShards[static_cast<size_t>(id) % SHARD_COUNT];
+}
+
+void ProcessRegistry::add(Process* proc) {
+    addBatch(&proc, 1);
+}
+
+void ProcessRegistry::addBatch(Process* const* procs, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Process* proc = procs[i];
+        {
+            NameShard& shard = nameShard(proc->name);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.emplace(proc->name, proc);
+        }
+        {
+            IdShard& shard = idShard(proc->id);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.emplace(proc->id, proc);
+        }
+    }
+    live.fetch_add(count, std::memory_order_release);
+}
+
+bool ProcessRegistry::containsName(const std::string& name) const {
+    NameShard& shard = nameShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.index.count(name) > 0;
+}
+
+Process* ProcessRegistry::findById(int id) const {
+    IdShard& shard = idShard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(id);
+    return it != shard.index.end() ? it->second : nullptr;
+}
+
+Process* ProcessRegistry::pinByName(const std::string& name) {
+    NameShard& shard = nameShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(name);
+    if (it == shard.index.end()) return nullptr;
+    ++shard.pins[it->second].count;
+    return it->second;
+}
+
+void ProcessRegistry::pin(Process* proc) {
+    NameShard& shard = nameShard(proc->name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.pins[proc].count;
+}
+
+bool ProcessRegistry::unpin(Process* proc) {
+    NameShard& shard = nameShard(proc->name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.pins.find(proc);
+    if (it == shard.pins.end() || --it->second.count > 0) return false;
+    bool retired = it->second.retired;
+    shard.pins.erase(it);
+    return retired;
+}
+
+bool ProcessRegistry::retire(Process* proc) {
+    {
+        IdShard& shard = idShard(proc->id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(proc->id);
+        if (it != shard.index.end() && it->second == proc) shard.index.erase(it);
+    }
+    live.fetch_sub(1, std::memory_order_release);
+
+    NameShard& shard = nameShard(proc->name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto named = shard.index.find(proc->name);
+    if (named != shard.index.end() && named->second == proc) shard.index.erase(named);
+    auto pinned = shard.pins.find(proc);
+    if (pinned == shard.pins.end()) return true;
+    pinned->second.retired = true;
+    return false;
+}
+
+void ProcessRegistry::deleteAll() {
+    for (auto& shard : idShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& entry : shard.index) delete entry.second;
+        shard.index.clear();
+    }
+    for (auto& shard : nameShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.pins.clear();
+    }
+    live.store(0, std::memory_order_release);
+}
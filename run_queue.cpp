@@ -0,0 +1,309 @@
+/*
+run_queue.cpp
+
+Implements the work-stealing ready queues. A core looks for work in its inbox, its own
+deque, then the global injection queue, then steals from the other cores' deques and
+inboxes; the global queue
+is also checked every GLOBAL_POLL_INTERVAL dispatches so that new processes are not
+starved by a core that keeps re-queueing its own preempted work. PriorityRunQueue and
+the core parking shared by both queue types are implemented here as well.
+*/
+
+#include "run_queue.h"
+#include "process.h"
+#include "clock_service.h"
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <chrono>
+
+static const uint32_t GLOBAL_POLL_INTERVAL = 61;
+static const auto PARK_TIMEOUT = std::chrono::milliseconds(100);
+
+static uint32_t lowestSetBit(uint64_t word) {
+#if defined(__GNUC__)
+    return static_cast<uint32_t>(__builtin_ctzll(word));
+#else
+    uint32_t bit = 0;
+    while (!(word & 1)) { word >>= 1; ++bit; }
+    return bit;
+#endif
+}
+
+WorkStealingDeque::WorkStealingDeque(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    buffer.reset(new std::atomic<Process*>[size]);
+    mask = static_cast<int64_t>(size - 1);
+}
+
+bool WorkStealingDeque::push(Process* proc) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t > mask) return false;
+    buffer[b & mask].store(proc, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Process* WorkStealingDeque::steal() {
+    while (true) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        Process* proc = buffer[t & mask].load(std::memory_order_relaxed);
+        if (top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return proc;
+        }
+    }
+}
+
+bool WorkStealingDeque::empty() const {
+    return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+}
+
+void RunQueues::configure(uint32_t cores) {
+    numCores = cores;
+    slots.reset(new CoreSlot[numCores]);
+    parking.configure(numCores);
+}
+
+void RunQueues::inject(Process* proc) {
+    {
+        auto lock = timedLock(globalMutex);
+        global.push_back(proc);
+        globalSize.fetch_add(1, std::memory_order_release);
+    }
+    parking.wakeOne();
+}
+
+void RunQueues::injectBatch(Process* const* procs, size_t count) {
+    if (count == 0) return;
+    {
+        auto lock = timedLock(globalMutex);
+        global.insert(global.end(), procs, procs + count);
+        globalSize.fetch_add(count, std::memory_order_release);
+    }
+    for (size_t i = 0; i < count && parking.wakeOne(); ++i) {}
+}
+
+void RunQueues::injectAffine(Process* proc) {
+    int preferredCore = proc->assignedCore;
+    if (preferredCore < 0 || uint32_t(preferredCore) >= numCores || !parking.isIdle(preferredCore)) {
+        inject(proc);
+        return;
+    }
+    CoreSlot& slot = slots[preferredCore];
+    {
+        std::lock_guard<std::mutex> lock(slot.inboxMutex);
+        slot.inbox.push_back(proc);
+        slot.inboxSize.fetch_add(1, std::memory_order_release);
+    }
+    // Woken elsewhere in the meantime: still ours first, and stealable by any core.
+    if (!parking.wakeCore(preferredCore)) parking.wakeOne();
+}
+
+void RunQueues::requeue(int coreId, Process* proc) {
+    if (!slots[coreId].local.push(proc)) {
+        inject(proc);
+        return;
+    }
+    parking.wakeOne();
+}
+
+Process* RunQueues::next(int coreId) {
+    CoreSlot& slot = slots[coreId];
+    Process* proc = nullptr;
+
+    if (++slot.dispatches % GLOBAL_POLL_INTERVAL == 0) proc = popGlobal();
+    if (!proc) proc = popInbox(slot);
+    if (!proc) proc = slot.local.steal();
+    if (!proc) proc = popGlobal();
+    if (!proc) proc = stealFrom(coreId);
+    return proc;
+}
+
+void RunQueues::drain(std::vector<Process*>& out) {
+    for (uint32_t i = 0; i < numCores; ++i) {
+        while (Process* proc = popInbox(slots[i])) out.push_back(proc);
+        while (Process* proc = slots[i].local.steal()) out.push_back(proc);
+    }
+    std::lock_guard<std::mutex> lock(globalMutex);
+    out.insert(out.end(), global.begin(), global.end());
+    global.clear();
+    globalSize.store(0);
+}
+
+Process* RunQueues::popInbox(CoreSlot& slot) {
+    if (slot.inboxSize.load(std::memory_order_acquire) == 0) return nullptr;
+    auto lock = timedLock(slot.inboxMutex);
+    if (slot.inbox.empty()) return nullptr;
+    Process* proc = slot.inbox.front();
+    slot.inbox.pop_front();
+    slot.inboxSize.fetch_sub(1, std::memory_order_release);
+    return proc;
+}
+
+Process* RunQueues::popGlobal() {
+    if (globalSize.load(std::memory_order_acquire) == 0) return nullptr;
+    auto lock = timedLock(globalMutex);
+    if (global.empty()) return nullptr;
+    Process* proc = global.front();
+    global.pop_front();
+    globalSize.fetch_sub(1, std::memory_order_release);
+    return proc;
+}
+
+Process* RunQueues::stealFrom(int thief) {
+    for (uint32_t i = 1; i < numCores; ++i) {
+        uint32_t victim = (thief + i) % numCores;
+        if (Process* proc = slots[victim].local.steal()) return proc;
+        if (Process* proc = popInbox(slots[victim])) return proc;
+    }
+    return nullptr;
+}
+
+bool RunQueues::hasWork() const {
+    if (globalSize.load(std::memory_order_acquire) > 0) return true;
+    for (uint32_t i = 0; i < numCores; ++i) {
+        if (!slots[i].local.empty() || slots[i].inboxSize.load(std::memory_order_acquire) > 0) return true;
+    }
+    return false;
+}
+
+void RunQueues::park(int coreId, const std::atomic<bool>& stop) {
+    parking.park(coreId, stop, [this] { return hasWork(); });
+}
+
+void RunQueues::wakeAll() {
+    parking.wakeAll();
+}
+
+void PriorityRunQueue::configure(uint32_t cores, ReadyOrder readyOrder) {
+    order = readyOrder;
+    parking.configure(cores);
+}
+
+uint64_t PriorityRunQueue::keyOf(const Process& proc) {
+    int remaining = proc.totalInstructions - proc.executedInstructions.load(std::memory_order_relaxed);
+    return remaining > 0 ? static_cast<uint64_t>(remaining) : 0;
+}
+
+void PriorityRunQueue::pushLocked(Process* proc) {
+    uint64_t key = order == ReadyOrder::ARRIVAL ? proc->times.arrivedAt : keyOf(*proc);
+    heap.push_back(Entry{key, seq++, proc});
+    std::push_heap(heap.begin(), heap.end(), Later());
+}
+
+void PriorityRunQueue::publishBest() {
+    best.store(heap.empty() ? UINT64_MAX : heap.front().key, std::memory_order_release);
+}
+
+void PriorityRunQueue::push(Process* proc) {
+    pushBatch(&proc, 1);
+}
+
+void PriorityRunQueue::pushBatch(Process* const* procs, size_t count) {
+    if (count == 0) return;
+    {
+        auto lock = timedLock(mutex);
+        for (size_t i = 0; i < count; ++i) pushLocked(procs[i]);
+        publishBest();
+    }
+    for (size_t i = 0; i < count && parking.wakeOne(); ++i) {}
+}
+
+Process* PriorityRunQueue::pop() {
+    if (bestKey() == UINT64_MAX) return nullptr;
+    auto lock = timedLock(mutex);
+    if (heap.empty()) return nullptr;
+    std::pop_heap(heap.begin(), heap.end(), Later());
+    Process* proc = heap.back().proc;
+    heap.pop_back();
+    publishBest();
+    return proc;
+}
+
+void PriorityRunQueue::drain(std::vector<Process*>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : heap) out.push_back(entry.proc);
+    heap.clear();
+    publishBest();
+}
+
+void PriorityRunQueue::park(int coreId, const std::atomic<bool>& stop) {
+    parking.park(coreId, stop, [this] { return bestKey() != UINT64_MAX; });
+}
+
+void PriorityRunQueue::wakeAll() {
+    parking.wakeAll();
+}
+
+void CoreParking::configure(uint32_t cores) {
+    numCores = cores;
+    slots.reset(new Slot[numCores]);
+    idleWords = (numCores + 63) / 64;
+    idleMask.reset(new std::atomic<uint64_t>[idleWords]);
+    for (size_t w = 0; w < idleWords; ++w) idleMask[w].store(0);
+}
+
+bool CoreParking::sleep(int coreId, const std::atomic<bool>& stop) {
+    Slot& slot = slots[coreId];
+    std::unique_lock<std::mutex> lock(slot.mutex);
+    slot.cond.wait_for(lock, PARK_TIMEOUT, [&] { return slot.notified || stop; });
+    bool notified = slot.notified;
+    slot.notified = false;
+    recordPark(notified, notified ? monotonicNanos() - slot.notifiedAt : 0);
+    return notified;
+}
+
+// Returns false when no core was idle.
+bool CoreParking::wakeOne() {
+    for (size_t w = 0; w < idleWords; ++w) {
+        uint64_t word = idleMask[w].load(std::memory_order_acquire);
+        while (word) {
+            uint64_t bit = uint64_t(1) << lowestSetBit(word);
+            uint64_t prev = idleMask[w].fetch_and(~bit, std::memory_order_acq_rel);
+            if (prev & bit) {
+                notify(static_cast<uint32_t>(w * 64 + lowestSetBit(bit)));
+                return true;
+            }
+            word = prev & ~bit;
+        }
+    }
+    return false;
+}
+
+bool CoreParking::isIdle(uint32_t coreId) const {
+    return idleMask[coreId / 64].load(std::memory_order_acquire) & (uint64_t(1) << (coreId % 64));
+}
+
+bool CoreParking::wakeCore(uint32_t coreId) {
+    uint64_t bit = uint64_t(1) << (coreId % 64);
+    if (!(idleMask[coreId / 64].fetch_and(~bit, std::memory_order_acq_rel) & bit)) return false;
+    notify(coreId);
+    return true;
+}
+
+void CoreParking::wakeAll() {
+    for (uint32_t i = 0; i < numCores; ++i) notify(i);
+}
+
+void CoreParking::notify(uint32_t coreId) {
+    Slot& slot = slots[coreId];
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (!slot.notified) slot.notifiedAt = monotonicNanos();
+        slot.notified = true;
+    }
+    slot.cond.notify_one();
+}
+
+void CoreParking::setIdle(uint32_t coreId, bool idle) {
+    uint64_t bit = uint64_t(1) << (coreId % 64);
+    if (idle) idleMask[coreId / 64].fetch_or(bit, std::memory_order_acq_rel);
+    else idleMask[coreId / 64].fetch_and(~bit, std::memory_order_acq_rel);
+}
@@ -0,0 +1,138 @@
+/*
+scheduler_policy.cpp
+
+Implements the policies that need more than a few lines; the simple ones live inline
+in scheduler_policy.h.
+*/
+
+#include "scheduler_policy.h"
+#include "process.h"
+
+void MlfqPolicy::configure(uint32_t cores, const Config& config) {
+    levelCount = std::min(std::max<uint32_t>(1, config.mlfqLevels), MLFQ_MAX_LEVELS);
+    levels.reset(new Level[levelCount]);
+    uint32_t base = std::max<uint32_t>(1, config.quantumCycles);
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        levels[i].quantum = i < config.mlfqQuanta.size() ? std::max<uint32_t>(1, config.mlfqQuanta[i]) : base << i;
+    }
+    boostInterval = config.mlfqBoostTicks;
+    nextBoost = boostInterval;
+    parking.configure(cores);
+}
+
+// change moves the process up (-1) or down (+1) a level. A process that was away
+// during a boost restarts at level 0 instead.
+void MlfqPolicy::push(Process* proc, int change) {
+    uint32_t current = epoch.load(std::memory_order_acquire);
+    int level = proc->boostEpoch == current ? proc->queueLevel + change : 0;
+    level = std::min(std::max(level, 0), int(levelCount) - 1);
+    proc->queueLevel = static_cast<uint8_t>(level);
+    proc->boostEpoch = current;
+
+    Level& target = levels[level];
+    {
+        auto lock = timedLock(target.mutex);
+        target.queue.push_back(proc);
+        target.size.fetch_add(1, std::memory_order_release);
+    }
+    parking.wakeOne();
+}
+
+void MlfqPolicy::onArrival(Process* const* procs, size_t count) {
+    if (count == 0) return;
+    uint32_t current = epoch.load(std::memory_order_acquire);
+    Level& top = levels[0];
+    {
+        std::lock_guard<std::mutex> lock(top.mutex);
+        for (size_t i = 0; i < count; ++i) {
+            procs[i]->queueLevel = 0;
+            procs[i]->boostEpoch = current;
+            top.queue.push_back(procs[i]);
+        }
+        top.size.fetch_add(count, std::memory_order_release);
+    }
+    for (size_t i = 0; i < count && parking.wakeOne(); ++i) {}
+}
+
+// Within the highest non-empty level, prefers a process that last ran on this core if
+// one is among the first MLFQ_AFFINITY_LOOKAHEAD entries; levels are never skipped.
+Process* MlfqPolicy::selectNext(int coreId) {
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        Level& level = levels[i];
+        if (level.size.load(std::memory_order_acquire) == 0) continue;
+        auto lock = timedLock(level.mutex);
+        if (level.queue.empty()) continue;
+        size_t scan = std::min<size_t>(level.queue.size(), MLFQ_AFFINITY_LOOKAHEAD);
+        size_t pick = 0;
+        for (size_t j = 0; j < scan; ++j) {
+            if (level.queue[j]->assignedCore == coreId) {
+                pick = j;
+                break;
+            }
+        }
+        Process* proc = level.queue[pick];
+        level.queue.erase(level.queue.begin() + pick);
+        level.size.fetch_sub(1, std::memory_order_release);
+        return proc;
+    }
+    return nullptr;
+}
+
+uint32_t MlfqPolicy::quantum(const Process& proc) const {
+    return levels[std::min<uint32_t>(proc.queueLevel, levelCount - 1)].quantum;
+}
+
+void MlfqPolicy::onQuantumExpiry(int, Process* proc) {
+    push(proc, +1);
+}
+
+void MlfqPolicy::onWake(Process* proc) {
+    push(proc, -1);
+}
+
+// Only the tick thread (or the simulator) calls this, so nextBoost needs no lock.
+void MlfqPolicy::onTick(uint64_t tick) {
+    if (boostInterval == 0 || tick < nextBoost) return;
+    nextBoost = tick + boostInterval;
+    boost();
+}
+
+void MlfqPolicy::boost() {
+    uint32_t current = epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+    Level& top = levels[0];
+    std::lock_guard<std::mutex> topLock(top.mutex);
+    for (Process* proc : top.queue) proc->boostEpoch = current;
+    for (uint32_t i = 1; i < levelCount; ++i) {
+        Level& level = levels[i];
+        std::lock_guard<std::mutex> lock(level.mutex);
+        for (Process* proc : level.queue) {
+            proc->queueLevel = 0;
+            proc->boostEpoch = current;
+            top.queue.push_back(proc);
+        }
+        top.size.fetch_add(level.queue.size(), std::memory_order_release);
+        level.size.store(0, std::memory_order_release);
+        level.queue.clear();
+    }
+}
+
+bool MlfqPolicy::hasWork() const {
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        if (levels[i].size.load(std::memory_order_acquire) > 0) return true;
+    }
+    return false;
+}
+
+void MlfqPolicy::park(int coreId, const std::atomic<bool>& stop) {
+    parking.park(coreId, stop, [this] { return hasWork(); });
+}
+
+void MlfqPolicy::drain(std::vector<Process*>& out) {
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        Level& level = levels[i];
+        std::lock_guard<std::mutex> lock(level.mutex);
+        out.insert(out.end(), level.queue.begin(), level.queue.end());
+        level.queue.clear();
+        level.size.store(0, std::memory_order_release);
+    }
+}
@@ -65,17 +65,14 @@ void printProcessInfo(const Process* proc) {
 
 void printProcessLogsAndDetails(const Process* proc) {
     std::cout << "Logs:\n";
-    for (const auto& msg : proc->logs) {
-        // Assume log format: "(timestamp) Core:X \"msg\""
-        size_t close_paren = msg.find(')');
-        if (close_paren != std::string::npos) {
-            std::string ts = msg.substr(1, close_paren - 1); // without '('
-            std::cout << "  ";
-            printColoredTimestamp(std::cout, ts);
-            std::cout << msg.substr(close_paren + 1) << "\n";
-        } else {
-            std::cout << msg << "\n";
-        }
+    uint64_t dropped = proc->logs.dropped();
+    if (dropped > 0) {
+        std::cout << "  (" << dropped << " older entries dropped)\n";
+    }
+    for (const auto& line : proc->readLogs()) {
+        std::cout << "  ";
+        printColoredTimestamp(std::cout, formatTimestamp(line.time));
+        std::cout << " Core:" << line.core << " \"" << line.message << "\"\n";
     }
     std::cout << "\n";
     std::cout << "Current instruction line: " << ORANGE << proc->executedInstructions << RESET << "\n";
@@ -0,0 +1,162 @@
+/*
+simulation.cpp
+
+Implements the headless --simulate mode: cores, process generation and the scheduler
+are driven by a discrete-event loop on a virtual clock measured in CPU ticks, so a full
+workload runs as fast as the host allows and is reproducible for a given seed.
+
+Time model: every executed instruction costs 1 + delay-per-exec ticks on its core,
+a SLEEP of n ticks takes the process off its core for n ticks, and a new process
+arrives every batch-process-freq ticks until processCount have been created.
+*/
+
+#include "core_manager.h"
+#include "process.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace {
+
+const int ARRIVAL_EVENT = -1;
+const int WAKE_EVENT = -2;
+
+struct SimEvent {
+    uint64_t time;
+    uint64_t seq;
+    int core;                   // the core whose quantum ends, or one of the above
+    Process* proc = nullptr;    // for WAKE_EVENT
+};
+
+struct LaterEvent {
+    bool operator()(const SimEvent& a, const SimEvent& b) const {
+        return a.time != b.time ? a.time > b.time : a.seq > b.seq;
+    }
+};
+
+}
+
+void CoreManager::runSimulation(uint64_t processCount, std::ostream& out) {
+    withPolicy(schedulerType, [&](auto tag) {
+        typename decltype(tag)::type policy;
+        policy.configure(numCores, settings);
+        simulate(policy, processCount, out);
+    });
+}
+
+template <class Policy>
+void CoreManager::simulate(Policy& policy, uint64_t processCount, std::ostream& out) {
+    const uint64_t stepCost = 1 + uint64_t(delayPerExec);
+    const uint64_t arrivalInterval = std::max<uint32_t>(1, batchProcessFreq);
+
+    std::priority_queue<SimEvent, std::vector<SimEvent>, LaterEvent> events;
+    std::vector<Process*> running(numCores, nullptr);
+    std::vector<SliceStop> stopReason(numCores, SliceStop::FINISHED);
+    std::vector<uint64_t> busyTicks(numCores, 0);
+    std::vector<uint64_t> coreSteps(numCores, 0);
+    uint64_t now = 0, seq = 0, created = 0, finished = 0, executed = 0;
+    metrics.clear(MetricUnit::TICKS);
+
+    // Runs one quantum at once; the core's next event is when it ends.
+    auto runQuantum = [&](uint32_t core, Process* proc) {
+        uint32_t quantum = policy.quantum(*proc);
+        uint32_t steps = 0;
+        SliceStop reason = SliceStop::QUANTUM_EXPIRED;
+        while (steps < quantum) {
+            SliceResult slice = proc->runSlice(quantum - steps);
+            steps += slice.steps;
+            reason = slice.reason;
+            if (reason == SliceStop::FINISHED) break;
+            if (reason == SliceStop::SLEEP) break;
+            reason = SliceStop::QUANTUM_EXPIRED;
+        }
+
+        running[core] = proc;
+        stopReason[core] = reason;
+        busyTicks[core] += steps * stepCost;
+        coreSteps[core] += steps;
+        events.push(SimEvent{now + steps * stepCost, seq++, int(core)});
+    };
+
+    auto dispatch = [&](uint32_t core) {
+        Process* proc = policy.selectNext(int(core));
+        if (!proc) return false;
+        proc->assignedCore = core;
+        proc->times.dispatch(now);
+        runQuantum(core, proc);
+        return true;
+    };
+
+    auto wallStart = std::chrono::steady_clock::now();
+    if (processCount > 0) events.push(SimEvent{0, seq++, ARRIVAL_EVENT});
+
+    while (!events.empty()) {
+        SimEvent ev = events.top();
+        events.pop();
+        now = ev.time;
+        policy.onTick(now);
+
+        if (ev.core == WAKE_EVENT) {
+            ev.proc->times.ready(now);
+            policy.onWake(ev.proc);
+        } else if (ev.core == ARRIVAL_EVENT) {
+            Process* proc = createProcess("process" + std::to_string(created), int(created));
+            proc->times.arrive(now);
+            policy.onArrival(&proc, 1);
+            if (++created < processCount) events.push(SimEvent{now + arrivalInterval, seq++, ARRIVAL_EVENT});
+        } else {
+            Process* proc = running[ev.core];
+            running[ev.core] = nullptr;
+            bool stays = stopReason[ev.core] == SliceStop::QUANTUM_EXPIRED && !policy.shouldPreempt(*proc);
+            if (!stays) proc->times.release(now);
+            if (stopReason[ev.core] == SliceStop::FINISHED) {
+                executed += proc->executedInstructions;
+                proc->times.finish(now);
+                metrics.record(*proc);
+                ++finished;
+                policy.onFinish(ev.core, proc);
+                delete proc;
+            } else if (stopReason[ev.core] == SliceStop::SLEEP) {
+                uint64_t ticks = std::max(1, proc->sleepTicks);
+                proc->sleepTicks = 0;
+                events.push(SimEvent{now + ticks, seq++, WAKE_EVENT, proc});
+            } else if (stays) {
+                runQuantum(ev.core, proc);
+            } else {
+                proc->times.preempt(now);
+                policy.onQuantumExpiry(ev.core, proc);
+            }
+        }
+
+        // Idle cores pick up work in core order so runs are deterministic.
+        for (uint32_t core = 0; core < numCores; ++core) {
+            if (!running[core] && !dispatch(core)) break;
+        }
+    }
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    out << "\n=== Simulation Report ===\n";
+    out << "Scheduler: " << schedulerType << "  Cores: " << numCores
+        << "  Quantum: " << quantumCycles << "  Seed: " << masterSeed << "\n";
+    out << "Processes finished: " << finished << " / " << processCount << "\n";
+    out << "Instructions executed: " << executed << "\n";
+    out << "Virtual ticks: " << now << "\n";
+    out << "Mean turnaround: " << std::fixed << std::setprecision(1)
+        << metrics.summary(Metric::TURNAROUND).mean << " ticks\n\n";
+    for (uint32_t i = 0; i < numCores; ++i) {
+        double util = now > 0 ? 100.0 * busyTicks[i] / now : 0.0;
+        out << "Core " << i << ": " << coreSteps[i] << " steps, "
+            << std::fixed << std::setprecision(1) << util << "% busy\n";
+    }
+    out << "\n";
+    metrics.print(out);
+    out << "\nWall time: " << std::fixed << std::setprecision(3) << wallSeconds << " s";
+    if (wallSeconds > 0) out << " (" << std::setprecision(0) << executed / wallSeconds << " instructions/s)";
+    out << "\n=========================\n\n";
+    out.unsetf(std::ios::floatfield);
+}
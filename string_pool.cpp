@@ -0,0 +1,105 @@
+/*
+string_pool.cpp
+
+Implements the interning table. Interning takes a mutex; reading an entry by id does
+not, since entries live in fixed chunks that are never moved once published.
+*/
+
+#include "string_pool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+const size_t CHUNK_SIZE = 1024;
+const size_t MAX_CHUNKS = 4096;
+const int PREINTERNED_NUMBERS = 256;
+
+struct Entry {
+    std::string text;
+    bool numeric = false;
+    uint16_t value = 0;
+};
+
+// Same result as static_cast<uint16_t>(std::stoi(text)) for decimal strings.
+bool parseConstant(const std::string& text, uint16_t& out) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    long v = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str()) return false;
+    out = static_cast<uint16_t>(v);
+    return true;
+}
+
+class Pool {
+public:
+    Pool() {
+        for (size_t i = 0; i < MAX_CHUNKS; ++i) chunks[i].store(nullptr, std::memory_order_relaxed);
+        for (int v = 0; v < PREINTERNED_NUMBERS; ++v) intern(std::to_string(v));
+    }
+
+    StrId intern(const std::string& text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(text);
+        if (it != index.end()) return it->second;
+
+        size_t chunk = count / CHUNK_SIZE;
+        if (chunk >= MAX_CHUNKS) throw std::runtime_error("String pool is full");
+        Entry* entries = chunks[chunk].load(std::memory_order_relaxed);
+        if (!entries) {
+            entries = new Entry[CHUNK_SIZE];
+            chunks[chunk].store(entries, std::memory_order_release);
+        }
+
+        Entry& entry = entries[count % CHUNK_SIZE];
+        entry.text = text;
+        entry.numeric = parseConstant(text, entry.value);
+        StrId id = static_cast<StrId>(count++);
+        index.emplace(text, id);
+        return id;
+    }
+
+    const Entry& at(StrId id) const {
+        return chunks[id / CHUNK_SIZE].load(std::memory_order_acquire)[id % CHUNK_SIZE];
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, StrId> index;
+    std::atomic<Entry*> chunks[MAX_CHUNKS];
+    size_t count = 0;
+};
+
+Pool& pool() {
+    static Pool instance;
+    return instance;
+}
+
+}
+
+StrId internString(const std::string& text) {
+    return pool().intern(text);
+}
+
+const std::string& internedString(StrId id) {
+    return pool().at(id).text;
+}
+
+bool internedNumber(StrId id, uint16_t& value) {
+    const Entry& entry = pool().at(id);
+    if (!entry.numeric) return false;
+    value = entry.value;
+    return true;
+}
+
+StrId numberString(int value) {
+    if (value >= 0 && value < PREINTERNED_NUMBERS) {
+        pool();
+        return static_cast<StrId>(value);
+    }
+    return internString(std::to_string(value));
+}
@@ -0,0 +1,37 @@
+/*
+timer_wheel.cpp
+
+Implements the sleep timer wheel. One lock covers the wheel; it is taken once per
+SLEEP and once per tick, never per instruction.
+*/
+
+#include "timer_wheel.h"
+
+TimerWheel::TimerWheel() : slots(TIMER_WHEEL_SLOTS) {}
+
+void TimerWheel::schedule(Process* proc, uint64_t ticks) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t due = now + (ticks > 0 ? ticks : 1);
+    slots[due % slots.size()].push_back(Timer{due, proc});
+    ++count;
+}
+
+void TimerWheel::advance(std::vector<Process*>& woken) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++now;
+    if (count == 0) return;
+
+    std::vector<Timer>& slot = slots[now % slots.size()];
+    size_t kept = 0;
+    for (const Timer& timer : slot) {
+        if (timer.due <= now) woken.push_back(timer.proc);
+        else slot[kept++] = timer;
+    }
+    count -= slot.size() - kept;
+    slot.resize(kept);
+}
+
+size_t TimerWheel::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
@@ -6,6 +6,7 @@ input handling) used throughout the OS Emulator project.
 */
 
 #include "util.h"
+#include "clock_service.h"
 #include <iostream>
 #include <chrono>
 #include <ctime>
@@ -25,9 +26,16 @@ input handling) used throughout the OS Emulator project.
 #define RESET "\033[0m"
 
 std::string getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    std::tm timeinfo = *std::localtime(&t);
+    return cachedTimestamp();
+}
+
+std::string formatTimestamp(std::time_t time) {
+    std::tm timeinfo;
+#ifdef _WIN32
+    localtime_s(&timeinfo, &time);
+#else
+    localtime_r(&time, &timeinfo);
+#endif
     char buffer[100];
     std::strftime(buffer, sizeof(buffer), "%m/%d/%Y %I:%M:%S %p", &timeinfo);
     return std::string(buffer);